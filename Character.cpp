@@ -1,4 +1,5 @@
 #include "Character.h"
+#include <numbers>
 
 namespace {
 	constexpr float CAR_LENGTH = 6.0f, WHEEL_RADIUS = 0.4f, WALL_THICKNESS = 0.08f, SEAT_HEIGHT = 1.3f;
@@ -8,33 +9,32 @@ namespace {
 	constexpr float CHARACTER_FORWARD_OFFSET_FRONT = (CAR_LENGTH / 2.0f - WALL_THICKNESS) * FRONT_SEAT_POS_RATIO + CHARACTER_BACKWARD_OFFSET;
 	constexpr float CHARACTER_FORWARD_OFFSET_BACK = (CAR_LENGTH / 2.0f - WALL_THICKNESS) * BACK_SEAT_POS_RATIO + CHARACTER_BACKWARD_OFFSET;
 	constexpr float CHARACTER_UP_OFFSET = WHEEL_RADIUS + WALL_THICKNESS + SEAT_HEIGHT * 0.1f;
-	constexpr float CHARACTER_SCALE = 3.0f, CHARACTER_BRIGHTNESS = 2.0f;
 
 	constexpr float BELT_UP_OFFSET = -1.15f, BELT_RIGHT_OFFSET = 0.3f, BELT_FORWARD_OFFSET = 0.0f;
+
+	// Characters face backwards in the car frame: model +x is the car's left, +z the car's forward.
+	const glm::quat CHARACTER_ROTATION = glm::angleAxis(std::numbers::pi_v<float> * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
 }
 
-Character::Character(const Model& belt, const std::string& modelPath, bool frontSeat) :
-	belt(belt), frontSeat(frontSeat), showBelt(false), visible(false), sick(false),
-	model(Model(modelPath, CHARACTER_SCALE, CHARACTER_BRIGHTNESS)) {
+Character::Character(const Model& belt, const Model& model) :
+	belt(belt), model(model) {
 }
 
-void Character::draw(const Shader& shader, const glm::vec3& carPosition, const glm::vec3& carForward, const glm::vec3& carUp, bool beltOnly) const {
-	if (!visible) return;
+void Character::draw(const Shader& shader, const Seat& seat, const glm::vec3& carPosition, const glm::quat& carOrientation, bool beltOnly) const {
+	if (!seat.visible) return;
 
-	float forwardOffset = frontSeat ? CHARACTER_FORWARD_OFFSET_FRONT : CHARACTER_FORWARD_OFFSET_BACK;
-	glm::vec3 worldPosition = carPosition + carForward * forwardOffset + carUp * CHARACTER_UP_OFFSET;
-	glm::vec3 characterForward = -carForward;
-	glm::vec3 characterUp = carUp;
+	float forwardOffset = seat.frontSeat ? CHARACTER_FORWARD_OFFSET_FRONT : CHARACTER_FORWARD_OFFSET_BACK;
+	glm::vec3 worldPosition = carPosition + carOrientation * glm::vec3(forwardOffset, CHARACTER_UP_OFFSET, 0.0f);
+	glm::quat characterOrientation = carOrientation * CHARACTER_ROTATION;
 
 	if (!beltOnly) {
-		if (sick) shader.setBool("applyGreenTint", true);
-		model.draw(shader, worldPosition, characterForward, characterUp);
-		if (sick) shader.setBool("applyGreenTint", false);
+		if (seat.sick) shader.setBool("applyGreenTint", true);
+		model.draw(shader, worldPosition, characterOrientation);
+		if (seat.sick) shader.setBool("applyGreenTint", false);
 	}
 
-	if (showBelt) {
-		glm::vec3 characterRight = glm::normalize(glm::cross(characterForward, characterUp));
-		glm::vec3 beltPosition = worldPosition + characterUp * BELT_UP_OFFSET + characterRight * BELT_RIGHT_OFFSET + characterForward * BELT_FORWARD_OFFSET;
-		belt.draw(shader, beltPosition, characterForward, characterUp);
+	if (seat.showBelt) {
+		glm::vec3 beltPosition = worldPosition + characterOrientation * glm::vec3(BELT_RIGHT_OFFSET, BELT_UP_OFFSET, -BELT_FORWARD_OFFSET);
+		belt.draw(shader, beltPosition, characterOrientation);
 	}
 }
\ No newline at end of file
@@ -1,33 +1,15 @@
 #pragma once
+#include "Circuit.h"
 #include "Shader.h"
 #include "Model.h"
-#include <string>
 
+// Draws one rider model in any seat; which seat and how it looks comes from the Seat.
 class Character {
 	const Model& belt;
-	Model model;
+	const Model& model;
 
 public:
-	bool frontSeat;
-	bool showBelt;
-	bool visible;
-	bool sick;
+	Character(const Model& belt, const Model& model);
 
-	Character(const Model& belt, const std::string& modelPath, bool frontSeat);
-
-	~Character() = default;
-	Character(Character&&) = default;
-	Character& operator=(Character&&) = default;
-	friend void swap(Character& a, Character& b) noexcept;
-
-	void draw(const Shader& shader, const glm::vec3& carPosition, const glm::vec3& carForward, const glm::vec3& carUp, bool beltOnly = false) const;
-};
-
-inline void swap(Character& a, Character& b) noexcept {
-	using std::swap;
-	swap(a.model, b.model);
-	swap(a.frontSeat, b.frontSeat);
-	swap(a.showBelt, b.showBelt);
-	swap(a.visible, b.visible);
-	swap(a.sick, b.sick);
-}
\ No newline at end of file
+	void draw(const Shader& shader, const Seat& seat, const glm::vec3& carPosition, const glm::quat& carOrientation, bool beltOnly = false) const;
+};
\ No newline at end of file
@@ -0,0 +1,332 @@
+#include "Circuit.h"
+#include "TrackBinary.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	constexpr float TRAIN_START_OFFSET = TrainPhysics::START_OFFSET, TRAIN_CAR_SPACE = TrainPhysics::CAR_SPACE;
+	constexpr float FINISH_SLOWDOWN_DISTANCE = TrainPhysics::FINISH_SLOWDOWN_DISTANCE;
+
+	constexpr float DISPATCH_INTERVAL = 6.0f;
+
+	bool onCircuit(TrainMode mode) {
+		return mode == TrainMode::RUNNING || mode == TrainMode::EMERGENCY_STOP || mode == TrainMode::SICK_MODE;
+	}
+}
+
+Circuit::Circuit(float simulationStep, int trainCount, int carCount, std::uint32_t seed)
+	: maxRunning(1), blockLength(0.0f), dispatchTimer(0.0f), dispatchRequested(false), random(seed), charactersCount(0), seatPage(0),
+	simulationStep(simulationStep), trains(std::max(trainCount, 1), TrainPhysics::atStation()), platformTrain(PLAYER_TRAIN),
+	carCount(std::clamp(carCount, TrainPhysics::MIN_CAR_COUNT, TrainPhysics::MAX_CAR_COUNT)), totalLength(0.0f) {
+
+	trainLength = TrainPhysics::length(this->carCount);
+
+	// Riders are numbered by the seat they start in; longer trains seat the same rider models again in the same order.
+	seats.resize(this->carCount * SEATS_PER_CAR);
+	for (int i = 0; i < (int)seats.size(); i++)
+		seats[i] = { i, i % SEATS_PER_CAR == 0, false, false, false };
+	for (int i = 1; i < (int)trains.size(); i++)
+		storage.push_back(i);
+
+	shuffleCharacters();
+}
+
+void Circuit::trackChanged(float totalLength, const std::function<float(float)>& pitchAt) {
+	this->totalLength = totalLength;
+	speedProfile = {};
+	if (totalLength > 0.0f)
+		speedProfile = TrainPhysics::buildSpeedProfile(totalLength, pitchAt, simulationStep, carCount);
+	buildBlocks();
+}
+
+// Blocks are counted from the station. A train waiting at the platform fills the last one,
+// so dispatching moves it into block 0.
+void Circuit::buildBlocks() {
+	int blockCount = TrainPhysics::blockCount(totalLength, carCount);
+	blockLength = totalLength / blockCount;
+	blockOwners.assign(blockCount, -1);
+	maxRunning = TrainPhysics::maxRunningTrains(totalLength, carCount);
+}
+
+const SpeedProfile& Circuit::getSpeedProfile() const {
+	return speedProfile;
+}
+
+int Circuit::getTrainCount() const {
+	return trains.size();
+}
+
+int Circuit::getBlockCount() const {
+	return blockOwners.size();
+}
+
+int Circuit::getCarCount() const {
+	return carCount;
+}
+
+int Circuit::getSeatCount() const {
+	return seats.size();
+}
+
+int Circuit::getSeatPage() const {
+	return seatPage;
+}
+
+const std::vector<Seat>& Circuit::getSeats() const {
+	return seats;
+}
+
+const TrainState& Circuit::getTrain(int trainIndex) const {
+	return trains[trainIndex];
+}
+
+// Everything a step can change, seating order included, without the render offsets that depend on the frame rate.
+std::uint64_t Circuit::getStateHash() const {
+	std::uint64_t hash = TrackBinary::hash(blockOwners.data(), blockOwners.size() * sizeof(int));
+	for (TrainState train : trains) {
+		train.renderOffset = 0.0f;
+		hash = TrackBinary::hash(&train, sizeof(TrainState), hash);
+	}
+	for (int index : storage)
+		hash = TrackBinary::hash(&index, sizeof(index), hash);
+	for (const Seat& seat : seats) {
+		bool flags[] = { seat.frontSeat, seat.showBelt, seat.visible, seat.sick };
+		std::ptrdiff_t rider = seat.rider;
+		hash = TrackBinary::hash(&rider, sizeof(rider), hash);
+		hash = TrackBinary::hash(flags, sizeof(flags), hash);
+	}
+
+	int counters[] = { platformTrain, charactersCount, dispatchRequested };
+	hash = TrackBinary::hash(counters, sizeof(counters), hash);
+	return TrackBinary::hash(&dispatchTimer, sizeof(dispatchTimer), hash);
+}
+
+// Blocks are half open at the start, so a front that stops exactly on a boundary stays in the block behind it.
+int Circuit::blockAt(float offset) const {
+	int blockCount = blockOwners.size();
+	int block = int(std::ceil((offset - TRAIN_START_OFFSET) / blockLength)) - 1;
+	return (block % blockCount + blockCount) % blockCount;
+}
+
+void Circuit::occupyBlocks() {
+	std::fill(blockOwners.begin(), blockOwners.end(), -1);
+	for (int i = 0; i < (int)trains.size(); i++) {
+		if (!isVisible(i)) continue;
+		// A train longer than the lap wraps its tail past its own front, so it holds every block.
+		int front = blockAt(trains[i].offset), block = blockAt(trains[i].offset - trainLength);
+		if (trainLength >= totalLength) block = (front + 1) % blockOwners.size();
+		for (; block != front; block = (block + 1) % blockOwners.size())
+			blockOwners[block] = i;
+		blockOwners[front] = i;
+	}
+}
+
+// Claims every block the front of the train crosses on its way from one offset to the next,
+// or leaves the train where it is if any of them belongs to another train.
+bool Circuit::enterBlocks(int trainIndex, float from, float to) {
+	int current = blockAt(from), target = blockAt(to);
+	for (int block = current; block != target;) {
+		block = (block + 1) % blockOwners.size();
+		if (blockOwners[block] >= 0 && blockOwners[block] != trainIndex)
+			return false;
+	}
+	for (int block = current; block != target;) {
+		block = (block + 1) % blockOwners.size();
+		blockOwners[block] = trainIndex;
+	}
+	return true;
+}
+
+// A train only leaves storage while it would still leave one block empty, so the trains on the
+// circuit can always move up and the platform never waits on a train that is waiting on it.
+// Trains too long for that run alone.
+void Circuit::dispatch(float delta) {
+	dispatchTimer = std::max(0.0f, dispatchTimer - delta);
+	int stationBlock = blockOwners.size() - 1;
+	int running = std::count_if(trains.begin(), trains.end(), [](const TrainState& train) { return onCircuit(train.mode); });
+
+	if (platformTrain < 0 && !storage.empty() && blockOwners[stationBlock] < 0 && running < maxRunning) {
+		platformTrain = storage.front();
+		storage.pop_front();
+		blockOwners[stationBlock] = platformTrain;
+	}
+	if (platformTrain < 0) return;
+
+	// The tail of a long train at the platform can reach round into the first block itself.
+	bool ready = platformTrain == PLAYER_TRAIN ? dispatchRequested : dispatchTimer <= 0.0f;
+	if (!ready || (blockOwners[0] >= 0 && blockOwners[0] != platformTrain))
+		return;
+
+	TrainState& train = trains[platformTrain];
+	train.mode = TrainMode::RUNNING;
+	train.rideTime = 0.0f;
+	if (platformTrain == PLAYER_TRAIN)
+		dispatchRequested = false;
+	platformTrain = -1;
+	dispatchTimer = DISPATCH_INTERVAL;
+}
+
+float Circuit::getCarDistance(const TrainState& train, int carIndex) const {
+	float targetDist = train.renderOffset - carIndex * TRAIN_CAR_SPACE;
+	if (train.renderOffset < totalLength + TRAIN_START_OFFSET - FINISH_SLOWDOWN_DISTANCE) {
+		while (targetDist < 0.0f) targetDist += totalLength;
+		while (targetDist >= totalLength) targetDist -= totalLength;
+	} else {
+		if (targetDist < 0.0f) targetDist = 0.0f;
+		if (targetDist >= totalLength) targetDist = totalLength - 0.01f;
+	}
+	return targetDist;
+}
+
+bool Circuit::isVisible(int trainIndex) const {
+	return trainIndex == platformTrain || onCircuit(trains[trainIndex].mode);
+}
+
+// The player's train comes first; in storage only its front car is kept, for the camera to follow.
+void Circuit::getCarDistances(std::vector<float>& distances) const {
+	distances.clear();
+	if (speedProfile.empty()) return;
+
+	for (int i = 0; i < (int)trains.size(); i++) {
+		int cars = isVisible(i) ? carCount : i == PLAYER_TRAIN ? 1 : 0;
+		for (int j = 0; j < cars; ++j)
+			distances.push_back(getCarDistance(trains[i], j));
+	}
+}
+
+void Circuit::press(RideInput input) {
+	TrainMode mode = getMode();
+	if (input <= RideInput::SEAT_8) {
+		int seat = seatPage * SEAT_PAGE_SIZE + int(input) - int(RideInput::SEAT_1);
+		if (mode == TrainMode::WAITING)
+			buckleUp(seat);
+		else if (mode == TrainMode::RUNNING)
+			makeSick(seat);
+	} else if (input == RideInput::NEXT_SEAT_PAGE) {
+		int pageCount = (getSeatCount() + SEAT_PAGE_SIZE - 1) / SEAT_PAGE_SIZE;
+		seatPage = (seatPage + 1) % pageCount;
+	} else if (input == RideInput::ADD_RIDER && mode == TrainMode::WAITING) {
+		addCharacter();
+	} else if (input == RideInput::START && mode == TrainMode::WAITING) {
+		start();
+	}
+}
+
+// Riders who need no keys: every seat taken, everyone buckled up and the train sent off as soon as it waits.
+void Circuit::boardAll() {
+	if (getMode() != TrainMode::WAITING) return;
+	while (charactersCount < (int)seats.size())
+		addCharacter();
+	for (int seat = 0; seat < charactersCount; seat++)
+		buckleUp(seat);
+	start();
+}
+
+void Circuit::shuffleCharacters() {
+	std::shuffle(seats.begin(), seats.end(), random);
+	for (int i = 0; i < seats.size(); i++)
+		seats[i].frontSeat = (i % SEATS_PER_CAR) == 0;
+}
+
+void Circuit::buckleUp(int seatNumber) {
+	if (seatNumber >= 0 && seatNumber < charactersCount)
+		seats[seatNumber].showBelt = true;
+}
+
+TrainMode Circuit::getMode() const {
+	return trains[PLAYER_TRAIN].mode;
+}
+
+void Circuit::setMode(TrainMode newMode) {
+	trains[PLAYER_TRAIN].mode = newMode;
+}
+
+void Circuit::addCharacter() {
+	if (charactersCount < seats.size()) {
+		seats[charactersCount].visible = true;
+		charactersCount++;
+	}
+}
+
+int Circuit::getCharactersCount() const {
+	return charactersCount;
+}
+
+void Circuit::start() {
+	if (charactersCount == 0) return;
+	for (int i = 0; i < charactersCount; i++)
+		if (!seats[i].showBelt)
+			return;
+	dispatchRequested = true;
+}
+
+void Circuit::makeSick(int seatNumber) {
+	if (seatNumber < 0 || seatNumber >= charactersCount) return;
+	seats[seatNumber].sick = true;
+	TrainPhysics::emergencyStop(trains[PLAYER_TRAIN], totalLength);
+}
+
+void Circuit::reset() {
+	charactersCount = 0;
+	dispatchRequested = false;
+
+	for (Seat& seat : seats) {
+		seat.showBelt = false;
+		seat.visible = false;
+		seat.sick = false;
+	}
+
+	shuffleCharacters();
+}
+
+// Back at the station: the train waits at the platform if it is free and in storage otherwise.
+void Circuit::arrive(int trainIndex) {
+	TrainState& train = trains[trainIndex];
+	train = TrainPhysics::atStation();
+
+	if (platformTrain < 0) platformTrain = trainIndex;
+	else storage.push_back(trainIndex);
+
+	if (trainIndex == PLAYER_TRAIN) {
+		train.mode = TrainMode::FINISHED;
+		reset();
+	}
+}
+
+void Circuit::update(float delta) {
+	if (speedProfile.empty()) return;
+
+	occupyBlocks();
+	dispatch(delta);
+
+	for (int i = 0; i < (int)trains.size(); i++) {
+		TrainState& train = trains[i];
+		train.previousOffset = train.offset;
+		if (onCircuit(train.mode))
+			advance(i, delta);
+	}
+}
+
+void Circuit::advance(int trainIndex, float delta) {
+	TrainState& train = trains[trainIndex];
+	TrainState next = TrainPhysics::step(train, speedProfile, totalLength, delta);
+	if (next.mode == TrainMode::FINISHED) {
+		arrive(trainIndex);
+		return;
+	}
+
+	// Held at the end of its block: the ride clock stops with it and picks up again once the way is clear.
+	// Settling on the emergency stop point only moves the train a hair, so it skips the check.
+	if (next.mode == train.mode && !enterBlocks(trainIndex, train.offset, next.offset)) {
+		train.preStopSpeed = next.preStopSpeed;
+		train.currentSpeed = 0.0f;
+		return;
+	}
+	train = next;
+}
+
+// Blends between the last two simulation steps, alpha being how far the frame is into the next one.
+void Circuit::interpolate(float alpha) {
+	for (TrainState& train : trains)
+		train.renderOffset = train.previousOffset + (train.offset - train.previousOffset) * alpha;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#include "TrainPhysics.h"
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+#include <deque>
+
+// What a key does to the ride, the same whether it was pressed or read back from an input log.
+// The seat inputs reach the seats of the current page.
+enum class RideInput {
+	SEAT_1, SEAT_2, SEAT_3, SEAT_4, SEAT_5, SEAT_6, SEAT_7, SEAT_8,
+	NEXT_SEAT_PAGE,
+	ADD_RIDER,
+	START
+};
+
+// One seat of the player's train; rider picks which of the riders sits in it.
+struct Seat {
+	int rider;
+	bool frontSeat;
+	bool showBelt;
+	bool visible;
+	bool sick;
+};
+
+// All trains on the circuit and the riders of the player's train, without anything to draw, so the
+// game, the park and the headless ride simulator run the same ride. Train 0 carries the passengers;
+// the others are dispatched from the station on their own. The lap is split into blocks that hold one train each.
+class Circuit {
+	std::vector<int> blockOwners;
+	std::deque<int> storage;
+	int maxRunning;
+	float trainLength, blockLength;
+	float dispatchTimer;
+	bool dispatchRequested;
+
+	std::mt19937 random;
+	int charactersCount;
+	int seatPage;
+	float simulationStep;
+	SpeedProfile speedProfile;
+
+	float getCarDistance(const TrainState& train, int carIndex) const;
+	void buildBlocks();
+
+	int blockAt(float offset) const;
+	void occupyBlocks();
+	bool enterBlocks(int trainIndex, float from, float to);
+	void dispatch(float delta);
+	void advance(int trainIndex, float delta);
+	void arrive(int trainIndex);
+
+protected:
+	static constexpr int PLAYER_TRAIN = 0;
+
+	std::vector<TrainState> trains;
+	std::vector<Seat> seats;
+	int platformTrain;
+	int carCount;
+	float totalLength;
+
+	bool isVisible(int trainIndex) const;
+
+public:
+	static constexpr int SEATS_PER_CAR = 2, SEAT_PAGE_SIZE = 8;
+
+	Circuit(float simulationStep, int trainCount = 1, int carCount = TrainPhysics::DEFAULT_CAR_COUNT, std::uint32_t seed = std::random_device()());
+
+	void trackChanged(float totalLength, const std::function<float(float)>& pitchAt);
+	void update(float delta);
+	void interpolate(float alpha);
+	void getCarDistances(std::vector<float>& distances) const;
+	void press(RideInput input);
+	void boardAll();
+
+	const SpeedProfile& getSpeedProfile() const;
+	int getTrainCount() const;
+	int getBlockCount() const;
+	int getCarCount() const;
+	int getSeatCount() const;
+	int getSeatPage() const;
+	const std::vector<Seat>& getSeats() const;
+	const TrainState& getTrain(int trainIndex) const;
+	std::uint64_t getStateHash() const;
+
+	void buckleUp(int seatNumber);
+	void shuffleCharacters();
+
+	TrainMode getMode() const;
+	void setMode(TrainMode newMode);
+	void makeSick(int seatNumber);
+	int getCharactersCount() const;
+	void addCharacter();
+	void start();
+	void reset();
+};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <limits>
 
 struct Bounds {
 	float x;
@@ -15,6 +17,7 @@ struct TrackPoint {
 	float pitch = 0.0f;
 	glm::vec3 center;
 	glm::vec3 perp;
+	glm::quat orientation;
 };
 
 struct OrientedPoint {
@@ -23,6 +26,28 @@ struct OrientedPoint {
 	glm::vec3 up;
 };
 
+// orientation maps +x to forward, +y to up and +z to right.
+struct TrackPose : OrientedPoint {
+	glm::quat orientation;
+	float pitch = 0.0f;
+};
+
+struct BoundingBox {
+	glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+	glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+	void grow(const glm::vec3& point) {
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+};
+
+struct Cylinder {
+	glm::vec3 bottom;
+	glm::vec3 top;
+	float radius;
+};
+
 struct Vertex {
 	glm::vec3 position;
 	glm::vec3 normal;
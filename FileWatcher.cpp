@@ -0,0 +1,50 @@
+#include "FileWatcher.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(const std::string& path) : path(std::filesystem::absolute(path)) {
+#ifdef __linux__
+	descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (descriptor < 0 || inotify_add_watch(descriptor, this->path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		std::cerr << "Failed to watch file: " << path << std::endl;
+#else
+	std::error_code error;
+	lastWrite = std::filesystem::last_write_time(this->path, error);
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+	if (descriptor >= 0) ::close(descriptor);
+#endif
+}
+
+bool FileWatcher::poll() {
+	bool changed = false;
+#ifdef __linux__
+	if (descriptor < 0) return false;
+
+	alignas(inotify_event) char buffer[4096];
+	ssize_t length;
+	while ((length = ::read(descriptor, buffer, sizeof(buffer))) > 0) {
+		for (char* it = buffer; it < buffer + length;) {
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(it);
+			if (event->len > 0 && path.filename() == event->name)
+				changed = true;
+			it += sizeof(inotify_event) + event->len;
+		}
+	}
+#else
+	std::error_code error;
+	auto write = std::filesystem::last_write_time(path, error);
+	if (!error && write != lastWrite) {
+		lastWrite = write;
+		changed = true;
+	}
+#endif
+	return changed;
+}
\ No newline at end of file
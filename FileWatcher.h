@@ -0,0 +1,23 @@
+#pragma once
+#include <filesystem>
+#include <string>
+
+// Reports when a single file is rewritten. Linux uses inotify on the parent directory so that
+// editors which save through a rename are caught too; other platforms compare modification times.
+class FileWatcher {
+	std::filesystem::path path;
+#ifdef __linux__
+	int descriptor = -1;
+#else
+	std::filesystem::file_time_type lastWrite;
+#endif
+
+public:
+	FileWatcher(const std::string& path);
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	bool poll();
+};
\ No newline at end of file
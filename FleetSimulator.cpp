@@ -0,0 +1,141 @@
+#include "FleetSimulator.h"
+#include "SimdLanes.h"
+#include <algorithm>
+
+FleetSimulator::FleetSimulator(const SpeedProfile& speedProfile, float totalLength, bool vectorized)
+	: speedProfile(speedProfile), totalLength(totalLength), vectorized(vectorized) {
+}
+
+// A rider getting sick is the only thing the passengers change about a ride, so that is all a ride
+// takes besides its dispatch time; a negative sick time means everyone keeps it together.
+size_t FleetSimulator::addRide(double dispatchTime, double sickTime) {
+	TrainState train = TrainPhysics::atStation();
+	offsets.push_back(train.offset);
+	currentSpeeds.push_back(train.currentSpeed);
+	preStopSpeeds.push_back(train.preStopSpeed);
+	stopDistances.push_back(train.stopDistance);
+	rideTimes.push_back(train.rideTime);
+	sleepTimers.push_back(train.sleepTimer);
+	modes.push_back(train.mode);
+	dispatchTimes.push_back(dispatchTime);
+	sickTimes.push_back(sickTime);
+	finishTimes.push_back(-1.0);
+	return modes.size() - 1;
+}
+
+double FleetSimulator::getTime() const {
+	return clock;
+}
+
+size_t FleetSimulator::getRideCount() const {
+	return modes.size();
+}
+
+size_t FleetSimulator::getActiveCount() const {
+	return std::count_if(modes.begin(), modes.end(), [](TrainMode mode) { return mode != TrainMode::FINISHED; });
+}
+
+TrainState FleetSimulator::getTrain(size_t ride) const {
+	return { offsets[ride], offsets[ride], offsets[ride], currentSpeeds[ride], preStopSpeeds[ride],
+		stopDistances[ride], rideTimes[ride], sleepTimers[ride], modes[ride] };
+}
+
+double FleetSimulator::getFinishTime(size_t ride) const {
+	return finishTimes[ride];
+}
+
+void FleetSimulator::setTrain(size_t ride, const TrainState& train) {
+	offsets[ride] = train.offset;
+	currentSpeeds[ride] = train.currentSpeed;
+	preStopSpeeds[ride] = train.preStopSpeed;
+	stopDistances[ride] = train.stopDistance;
+	rideTimes[ride] = train.rideTime;
+	sleepTimers[ride] = train.sleepTimer;
+	modes[ride] = train.mode;
+}
+
+// Each ride is a single train, so it is the player's train of Train and stays at the station once it is back.
+void FleetSimulator::finish(size_t ride) {
+	TrainState train = TrainPhysics::atStation();
+	train.mode = TrainMode::FINISHED;
+	setTrain(ride, train);
+	finishTimes[ride] = clock;
+}
+
+void FleetSimulator::stepOne(size_t ride, float delta) {
+	if (modes[ride] == TrainMode::WAITING || modes[ride] == TrainMode::FINISHED) return;
+	TrainState next = TrainPhysics::step(getTrain(ride), speedProfile, totalLength, delta);
+	if (next.mode == TrainMode::FINISHED) finish(ride);
+	else setTrain(ride, next);
+}
+
+// SpeedProfile::distanceAt and speedAt for Lanes::WIDTH trains at once, with the same operations
+// in the same order so every lane matches the scalar lookup bit for bit. Past the last sample the
+// two gathered values are the same and the blend returns it unchanged, like the scalar early out.
+// Only RUNNING trains take the result; the rest of the block is stepped one by one.
+template<typename Lanes>
+void FleetSimulator::stepBlock(size_t first, float delta) {
+	if (std::none_of(modes.begin() + first, modes.begin() + first + Lanes::WIDTH, [](TrainMode mode) { return mode == TrainMode::RUNNING; })) {
+		for (size_t ride = first; ride < first + Lanes::WIDTH; ++ride)
+			stepOne(ride, delta);
+		return;
+	}
+
+	const std::vector<float>& distances = speedProfile.getDistances();
+	const std::vector<float>& speeds = speedProfile.getSpeeds();
+	auto last = Lanes::splatInt(int(distances.size()) - 1);
+
+	auto time = Lanes::add(Lanes::load(&rideTimes[first]), Lanes::splat(delta));
+	auto position = Lanes::max(Lanes::div(time, Lanes::splat(speedProfile.getStep())), Lanes::splat(0.0f));
+	auto index = Lanes::minInt(Lanes::truncate(position), last);
+	auto next = Lanes::minInt(Lanes::addInt(index, Lanes::splatInt(1)), last);
+	auto t = Lanes::sub(position, Lanes::toFloat(index));
+
+	auto distance = Lanes::gather(distances, index), speed = Lanes::gather(speeds, index);
+	distance = Lanes::add(distance, Lanes::mul(Lanes::sub(Lanes::gather(distances, next), distance), t));
+	speed = Lanes::add(speed, Lanes::mul(Lanes::sub(Lanes::gather(speeds, next), speed), t));
+
+	float laneTimes[Lanes::WIDTH], laneDistances[Lanes::WIDTH], laneSpeeds[Lanes::WIDTH];
+	Lanes::store(laneTimes, time);
+	Lanes::store(laneDistances, distance);
+	Lanes::store(laneSpeeds, speed);
+
+	float duration = speedProfile.duration();
+	for (size_t lane = 0; lane < Lanes::WIDTH; ++lane) {
+		size_t ride = first + lane;
+		if (modes[ride] != TrainMode::RUNNING) {
+			stepOne(ride, delta);
+		} else if (laneTimes[lane] >= duration) {
+			finish(ride);
+		} else {
+			rideTimes[ride] = laneTimes[lane];
+			offsets[ride] = laneDistances[lane];
+			currentSpeeds[ride] = laneSpeeds[lane];
+		}
+	}
+}
+
+void FleetSimulator::update(float delta) {
+	if (speedProfile.empty()) return;
+
+	for (size_t ride = 0; ride < modes.size(); ++ride) {
+		if (modes[ride] == TrainMode::WAITING && clock >= dispatchTimes[ride]) {
+			modes[ride] = TrainMode::RUNNING;
+			rideTimes[ride] = 0.0f;
+		}
+		if (modes[ride] == TrainMode::RUNNING && sickTimes[ride] >= 0.0 && clock >= sickTimes[ride]) {
+			TrainState train = getTrain(ride);
+			TrainPhysics::emergencyStop(train, totalLength);
+			setTrain(ride, train);
+		}
+	}
+
+	// Without a SIMD instruction set the lanes are one float wide and the block path only adds overhead.
+	size_t ride = 0;
+	if (vectorized && SimdLanes::WIDTH > 1)
+		for (; ride + SimdLanes::WIDTH <= modes.size(); ride += SimdLanes::WIDTH)
+			stepBlock<SimdLanes>(ride, delta);
+	for (; ride < modes.size(); ++ride)
+		stepOne(ride, delta);
+	clock += delta;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include "TrainPhysics.h"
+#include <vector>
+
+// Many independent rides of the same train on copies of one circuit, for capacity studies.
+// Each part of the train state is its own column, so trains that are replaying the speed
+// profile are stepped a register at a time; stopping and sick trains fall back to TrainPhysics::step.
+class FleetSimulator {
+	const SpeedProfile& speedProfile;
+	float totalLength;
+	bool vectorized;
+	double clock = 0.0;
+
+	std::vector<float> offsets, currentSpeeds, preStopSpeeds, stopDistances, rideTimes, sleepTimers;
+	std::vector<TrainMode> modes;
+	std::vector<double> dispatchTimes, sickTimes, finishTimes;
+
+	void setTrain(size_t ride, const TrainState& train);
+	void finish(size_t ride);
+	void stepOne(size_t ride, float delta);
+	template<typename Lanes>
+	void stepBlock(size_t first, float delta);
+
+public:
+	FleetSimulator(const SpeedProfile& speedProfile, float totalLength, bool vectorized = true);
+
+	size_t addRide(double dispatchTime, double sickTime = -1.0);
+	void update(float delta);
+
+	double getTime() const;
+	size_t getRideCount() const;
+	size_t getActiveCount() const;
+	TrainState getTrain(size_t ride) const;
+	double getFinishTime(size_t ride) const;
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "Frustum.h"
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+	auto row = [&](int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+
+	for (int i = 0; i < 3; ++i) {
+		planes[i * 2] = row(3) + row(i);
+		planes[i * 2 + 1] = row(3) - row(i);
+	}
+}
+
+bool Frustum::intersects(const BoundingBox& box) const {
+	for (const auto& plane : planes) {
+		glm::vec3 farthest(plane.x > 0 ? box.max.x : box.min.x, plane.y > 0 ? box.max.y : box.min.y, plane.z > 0 ? box.max.z : box.min.z);
+		if (plane.x * farthest.x + plane.y * farthest.y + plane.z * farthest.z + plane.w < 0.0f)
+			return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+#include "DataClasses.h"
+#include <glm/glm.hpp>
+
+class Frustum {
+	glm::vec4 planes[6];
+
+public:
+	Frustum(const glm::mat4& viewProjection);
+
+	bool intersects(const BoundingBox& box) const;
+};
\ No newline at end of file
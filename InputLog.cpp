@@ -0,0 +1,161 @@
+#include "InputLog.h"
+#include "MappedFile.h"
+#include <iostream>
+#include <cstring>
+
+namespace {
+	constexpr char MAGIC[8] = { 'S', 'M', 'R', 'T', 'L', 'O', 'G', '\0' };
+	constexpr std::uint32_t VERSION = 3;
+	constexpr std::uint8_t STEP_RECORD = 0, INPUT_RECORD = 1;
+	constexpr std::uint32_t FLUSH_INTERVAL = 240;
+
+	// The 64-bit state hash folded in half; a step costs five bytes in the log.
+	std::uint32_t fold(std::uint64_t hash) {
+		return std::uint32_t(hash ^ (hash >> 32));
+	}
+
+	template<typename T>
+	bool read(const char*& cursor, const char* end, T& value) {
+		if (end - cursor < std::ptrdiff_t(sizeof(T))) return false;
+		std::memcpy(&value, cursor, sizeof(T));
+		cursor += sizeof(T);
+		return true;
+	}
+}
+
+bool InputLog::record(const std::string& path, std::uint32_t seed, int carCount, int trainCount, float simulationStep) {
+	this->seed = seed;
+	this->carCount = carCount;
+	this->trainCount = trainCount;
+	this->simulationStep = simulationStep;
+	output.open(path, std::ios::binary | std::ios::trunc);
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.seed = seed;
+	header.carCount = carCount;
+	header.trainCount = trainCount;
+	header.simulationStep = simulationStep;
+	output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	output.flush();
+
+	if (!output) {
+		output.close();
+		std::cerr << "Failed to open input log for writing: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Inputs carry no step number: they belong to the step after the last hash before them. A log cut
+// short by a crash or Esc simply ends at its last complete record; one without a single step has
+// nothing to replay.
+bool InputLog::load(const std::string& path) {
+	MappedFile file(path);
+	Header header;
+	if (!file.isOpen() || file.size() < sizeof(Header)) {
+		std::cerr << "Failed to open input log: " << path << std::endl;
+		return false;
+	}
+
+	std::memcpy(&header, file.data(), sizeof(Header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+		std::cerr << "Not an input log: " << path << std::endl;
+		return false;
+	}
+
+	seed = header.seed;
+	carCount = header.carCount;
+	trainCount = header.trainCount;
+	simulationStep = header.simulationStep;
+	const char* cursor = file.data() + sizeof(Header), * end = file.data() + file.size();
+	std::uint8_t type;
+	while (read(cursor, end, type)) {
+		if (type == STEP_RECORD) {
+			std::uint32_t hash;
+			if (!read(cursor, end, hash)) break;
+			hashes.push_back(hash);
+		} else if (type == INPUT_RECORD) {
+			std::int16_t input;
+			if (!read(cursor, end, input)) break;
+			inputs.push_back({ std::uint32_t(hashes.size()), RideInput(input) });
+		} else {
+			break;
+		}
+	}
+
+	if (hashes.empty()) {
+		inputs.clear();
+		std::cerr << "Input log has no steps: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool InputLog::isRecording() const {
+	return output.is_open();
+}
+
+bool InputLog::isReplaying() const {
+	return !hashes.empty();
+}
+
+bool InputLog::isFinished() const {
+	return isReplaying() && tick >= hashes.size() && nextInput >= inputs.size();
+}
+
+void InputLog::pressed(RideInput input) {
+	if (!isRecording()) return;
+	std::int16_t value = std::int16_t(input);
+	output.put(char(INPUT_RECORD));
+	output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	output.flush();
+}
+
+bool InputLog::popInput(RideInput& input) {
+	if (nextInput >= inputs.size() || inputs[nextInput].tick != tick) return false;
+	input = inputs[nextInput++].input;
+	return true;
+}
+
+void InputLog::stepped(std::uint64_t stateHash) {
+	std::uint32_t hash = fold(stateHash);
+	if (isRecording()) {
+		output.put(char(STEP_RECORD));
+		output.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+		if ((tick + 1) % FLUSH_INTERVAL == 0)
+			output.flush();
+	} else if (tick < hashes.size() && hashes[tick] != hash) {
+		if (mismatches++ == 0)
+			firstMismatch = tick;
+	}
+	tick++;
+}
+
+std::uint32_t InputLog::getSeed() const {
+	return seed;
+}
+
+int InputLog::getCarCount() const {
+	return carCount;
+}
+
+int InputLog::getTrainCount() const {
+	return trainCount;
+}
+
+float InputLog::getSimulationStep() const {
+	return simulationStep;
+}
+
+std::uint32_t InputLog::getTick() const {
+	return tick;
+}
+
+size_t InputLog::getMismatchCount() const {
+	return mismatches;
+}
+
+std::uint32_t InputLog::getFirstMismatch() const {
+	return firstMismatch;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include "Circuit.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// A session reduced to what the simulation saw: the seed the riders are shuffled with, the train
+// and car counts, the simulation step, every ride input at the step it arrived before, and a hash
+// of the ride after each step.
+// Recording appends to the file as it goes; replaying hands the inputs back at the same steps and
+// checks every hash against the recorded one.
+class InputLog {
+	struct Header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t seed;
+		std::int32_t carCount;
+		std::int32_t trainCount;
+		float simulationStep;
+	};
+
+	struct Input {
+		std::uint32_t tick;
+		RideInput input;
+	};
+
+	std::ofstream output;
+	std::vector<Input> inputs;
+	std::vector<std::uint32_t> hashes;
+	std::uint32_t seed = 0, tick = 0;
+	int carCount = 0, trainCount = 0;
+	float simulationStep = 0.0f;
+	size_t nextInput = 0, mismatches = 0;
+	std::uint32_t firstMismatch = 0;
+
+public:
+	bool record(const std::string& path, std::uint32_t seed, int carCount, int trainCount, float simulationStep);
+	bool load(const std::string& path);
+
+	bool isRecording() const;
+	bool isReplaying() const;
+	bool isFinished() const;
+
+	void pressed(RideInput input);
+	bool popInput(RideInput& input);
+	void stepped(std::uint64_t stateHash);
+
+	std::uint32_t getSeed() const;
+	int getCarCount() const;
+	int getTrainCount() const;
+	float getSimulationStep() const;
+	std::uint32_t getTick() const;
+	size_t getMismatchCount() const;
+	std::uint32_t getFirstMismatch() const;
+};
\ No newline at end of file
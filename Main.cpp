@@ -1,14 +1,40 @@
 ﻿#include "Windows.h"
 #include "Smrtovlak.h"
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+namespace {
+	// --record <file> writes an input log of the session, --replay <file> plays one back and
+	// --cars <count> sets the length of the trains and --spline <control points> rides a spline fitted through the track.
+	// A log that cannot be replayed ends the game before it opens a window.
+	int runSmrtovlak(int argc, char** argv) {
+		std::string recordPath, replayPath;
+		int carCount = TrainPhysics::DEFAULT_CAR_COUNT;
+		size_t splineControlPoints = 0;
+		for (int i = 1; i + 1 < argc; i += 2) {
+			std::string arg = argv[i];
+			if (arg == "--record") recordPath = argv[i + 1];
+			else if (arg == "--replay") replayPath = argv[i + 1];
+			else if (arg == "--cars") carCount = std::atoi(argv[i + 1]);
+			else if (arg == "--spline") splineControlPoints = std::strtoul(argv[i + 1], nullptr, 10);
+		}
+
+		InputLog replayLog;
+		if (!replayPath.empty() && !replayLog.load(replayPath))
+			return 1;
+
+		Smrtovlak smrtovlak(carCount, splineControlPoints, recordPath, std::move(replayLog));
+		return smrtovlak.run();
+	}
+}
 
 #ifdef _DEBUG
-int main() {
-	Smrtovlak smrtovlak;
-	return smrtovlak.run();
+int main(int argc, char** argv) {
+	return runSmrtovlak(argc, argv);
 }
 #else
 int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
-	Smrtovlak smrtovlak;
-	return smrtovlak.run();
+	return runSmrtovlak(__argc, __argv);
 }
 #endif
\ No newline at end of file
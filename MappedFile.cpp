@@ -0,0 +1,92 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;
+
+	mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) return;
+
+	bytes = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (bytes) length = static_cast<size_t>(fileSize.QuadPart);
+#else
+	descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0) return;
+
+	struct stat info;
+	if (fstat(descriptor, &info) != 0 || info.st_size == 0) return;
+
+	void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (view == MAP_FAILED) return;
+
+	bytes = static_cast<const char*>(view);
+	length = static_cast<size_t>(info.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		close();
+		bytes = std::exchange(other.bytes, nullptr);
+		length = std::exchange(other.length, 0);
+#ifdef _WIN32
+		fileHandle = std::exchange(other.fileHandle, nullptr);
+		mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#else
+		descriptor = std::exchange(other.descriptor, -1);
+#endif
+	}
+	return *this;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+	if (bytes) UnmapViewOfFile(bytes);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle) CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (bytes) munmap(const_cast<char*>(bytes), length);
+	if (descriptor >= 0) ::close(descriptor);
+	descriptor = -1;
+#endif
+	bytes = nullptr;
+	length = 0;
+}
+
+bool MappedFile::isOpen() const {
+	return bytes != nullptr;
+}
+
+const char* MappedFile::data() const {
+	return bytes;
+}
+
+size_t MappedFile::size() const {
+	return length;
+}
\ No newline at end of file
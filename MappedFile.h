@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+
+class MappedFile {
+	const char* bytes = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#else
+	int descriptor = -1;
+#endif
+
+	void close();
+
+public:
+	MappedFile() = default;
+	MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	bool isOpen() const;
+	const char* data() const;
+	size_t size() const;
+};
\ No newline at end of file
@@ -6,7 +6,7 @@
 #include <fstream>
 #include <sstream>
 
-Model::Model(const std::string& objPath, float scale, float brightness) : scale(scale), brightness(brightness) {
+Model::Model(const std::string& objPath, float scale, float brightness, VertexFormat vertexFormat) : vertexFormat(vertexFormat), brightness(brightness), scale(scale) {
 	size_t lastSlash = objPath.find_last_of("/\\");
 	directory = (lastSlash != std::string::npos) ? objPath.substr(0, lastSlash + 1) : "";
 	loadOBJ(objPath);
@@ -20,7 +20,7 @@ Model::~Model() {
 	}
 }
 
-Model::Model(Model&& other) noexcept : meshGroups(std::move(other.meshGroups)), directory(std::move(other.directory)), scale(other.scale), brightness(other.brightness) {
+Model::Model(Model&& other) noexcept : meshGroups(std::move(other.meshGroups)), directory(std::move(other.directory)), vertexFormat(other.vertexFormat), brightness(other.brightness), scale(other.scale) {
 	for (auto& group : other.meshGroups) {
 		group.VAO = 0;
 		group.VBO = 0;
@@ -38,6 +38,7 @@ Model& Model::operator=(Model&& other) noexcept {
 
 		meshGroups = std::move(other.meshGroups);
 		directory = std::move(other.directory);
+		vertexFormat = other.vertexFormat;
 		brightness = other.brightness;
 		scale = other.scale;
 
@@ -186,6 +187,7 @@ void Model::loadOBJ(const std::string& path) {
 		MeshGroup group;
 		group.material = materials[materialName];
 		group.indexCount = groupIndices[materialName].size();
+		group.vertices = EncodedVertices(vertices, vertexFormat);
 
 		glGenVertexArrays(1, &group.VAO);
 		glGenBuffers(1, &group.VBO);
@@ -193,31 +195,23 @@ void Model::loadOBJ(const std::string& path) {
 		glBindVertexArray(group.VAO);
 
 		glBindBuffer(GL_ARRAY_BUFFER, group.VBO);
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+		group.vertices.upload();
+		group.vertices.releaseData();
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, group.EBO);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, groupIndices[materialName].size() * sizeof(unsigned int),
 			groupIndices[materialName].data(), GL_STATIC_DRAW);
 
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-		glEnableVertexAttribArray(1);
 		glBindVertexArray(0);
 
 		meshGroups.push_back(std::move(group));
 	}
 }
 
-void Model::draw(const Shader& shader, const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up) const {
-	glm::vec3 f = glm::normalize(forward), u = glm::normalize(up);
-	glm::vec3 r = glm::normalize(glm::cross(f, u));
-	u = glm::normalize(glm::cross(r, f));
-
-	glm::mat4 model(1.0f);
-	model[0] = glm::vec4(r * scale, 0.0f);
-	model[1] = glm::vec4(u * scale, 0.0f);
-	model[2] = glm::vec4(-f * scale, 0.0f);
+void Model::draw(const Shader& shader, const glm::vec3& position, const glm::quat& orientation) const {
+	glm::mat4 model = glm::mat4_cast(orientation);
+	for (int axis = 0; axis < 3; ++axis)
+		model[axis] *= scale;
 	model[3] = glm::vec4(position, 1.0f);
 
 	shader.setMat4("model", glm::value_ptr(model));
@@ -225,8 +219,10 @@ void Model::draw(const Shader& shader, const glm::vec3& position, const glm::vec
 	for (const auto& group : meshGroups) {
 		glm::vec3 color = group.material.diffuse * brightness;
 		shader.setVec3("baseColor", color.r, color.g, color.b);
+		group.vertices.bind(shader);
 		glBindVertexArray(group.VAO);
 		glDrawElements(GL_TRIANGLES, group.indexCount, GL_UNSIGNED_INT, 0);
 		glBindVertexArray(0);
 	}
+	EncodedVertices::unbind(shader);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <unordered_map>
 #include "DataClasses.h"
+#include "VertexFormat.h"
 #include <glm/glm.hpp>
 #include "Shader.h"
 #include <string>
@@ -19,12 +20,14 @@ struct MeshGroup {
 	unsigned int VBO = 0;
 	unsigned int EBO = 0;
 	unsigned int indexCount = 0;
+	EncodedVertices vertices;
 	Material material;
 };
 
 class Model {
 	std::vector<MeshGroup> meshGroups;
 	std::string directory;
+	VertexFormat vertexFormat;
 
 	void loadOBJ(const std::string& path);
 	std::unordered_map<std::string, Material> loadMTL(const std::string& path);
@@ -33,11 +36,11 @@ public:
 	float brightness;
 	float scale;
 
-	Model(const std::string& objPath, float scale = 1.0f, float brightness = 1.0f);
+	Model(const std::string& objPath, float scale = 1.0f, float brightness = 1.0f, VertexFormat vertexFormat = VertexFormat::PACKED);
 	~Model();
 
 	Model(Model&& other) noexcept;
 	Model& operator=(Model&& other) noexcept;
 
-	void draw(const Shader& shader, const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up) const;
+	void draw(const Shader& shader, const glm::vec3& position, const glm::quat& orientation) const;
 };
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Splits [0, count) into one contiguous range per hardware thread and runs body(begin, end)
+// on each; small inputs stay on the calling thread.
+template<typename Body>
+void parallelFor(size_t count, Body&& body, size_t minRange = 1024) {
+	size_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+	size_t workers = std::clamp<size_t>(count / minRange, 1, maxWorkers);
+	if (workers == 1) {
+		body(size_t(0), count);
+		return;
+	}
+
+	size_t range = (count + workers - 1) / workers;
+	std::vector<std::thread> threads;
+	for (size_t begin = range; begin < count; begin += range)
+		threads.emplace_back([&body, begin, end = std::min(begin + range, count)] { body(begin, end); });
+
+	body(size_t(0), range);
+	for (auto& thread : threads) thread.join();
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "Park.h"
+
+Park::Park(const TrackIndex& index, float simulationStep, int rideCount, int trainCount, int carCount)
+	: index(index), simulationStep(simulationStep) {
+	rides.reserve(rideCount);
+	for (int i = 0; i < rideCount; i++) {
+		rides.push_back({ Circuit(simulationStep, trainCount, carCount, std::uint32_t(i)) });
+		rides.back().circuit.trackChanged(index.length(), [&index](float distance) { return index.pitchAt(distance); });
+	}
+}
+
+// Everything here stays inside the one ride; the shared track is only read.
+void Park::stepRide(Ride& ride, int steps, float alpha) {
+	Circuit& circuit = ride.circuit;
+	for (int step = 0; step < steps; step++) {
+		circuit.boardAll();
+		circuit.update(simulationStep);
+		if (circuit.getMode() == TrainMode::FINISHED)
+			circuit.setMode(TrainMode::WAITING);
+	}
+
+	circuit.interpolate(alpha);
+	circuit.getCarDistances(ride.carDistances);
+	ride.carPoses.resize(ride.carDistances.size());
+	index.poseAt(ride.carDistances, ride.carPoses);
+}
+
+// One frame: every ride takes the same steps and ends up with its poses ready to draw.
+void Park::update(RideScheduler& scheduler, int steps, float alpha) {
+	scheduler.tick(rides.size(), [&](size_t ride) { stepRide(rides[ride], steps, alpha); });
+}
+
+size_t Park::getRideCount() const {
+	return rides.size();
+}
+
+const Circuit& Park::getRide(size_t ride) const {
+	return rides[ride].circuit;
+}
+
+size_t Park::getPoseCount() const {
+	size_t poses = 0;
+	for (const Ride& ride : rides)
+		poses += ride.carPoses.size();
+	return poses;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "RideScheduler.h"
+#include "TrackIndex.h"
+#include "Circuit.h"
+#include <vector>
+
+// Several coasters on one shared track, each with its own trains and riders, stepped side by side
+// by a RideScheduler. The riders board and send their train off on their own. Nothing here touches
+// GL: a ride is its Circuit and the car poses looked up from the shared TrackIndex every frame.
+class Park {
+	struct Ride {
+		Circuit circuit;
+		std::vector<float> carDistances;
+		std::vector<TrackPose> carPoses;
+	};
+
+	const TrackIndex& index;
+	std::vector<Ride> rides;
+	float simulationStep;
+
+	void stepRide(Ride& ride, int steps, float alpha);
+
+public:
+	Park(const TrackIndex& index, float simulationStep, int rideCount, int trainCount, int carCount);
+
+	void update(RideScheduler& scheduler, int steps, float alpha);
+	size_t getRideCount() const;
+	const Circuit& getRide(size_t ride) const;
+	size_t getPoseCount() const;
+};
\ No newline at end of file
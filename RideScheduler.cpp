@@ -0,0 +1,88 @@
+#include "RideScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+RideScheduler::RideScheduler(size_t workerCount) : stats(std::max<size_t>(workerCount, 1)) {
+	for (size_t worker = 1; worker < stats.size(); ++worker)
+		threads.emplace_back(&RideScheduler::work, this, worker);
+}
+
+RideScheduler::~RideScheduler() {
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+	for (auto& thread : threads) thread.join();
+}
+
+void RideScheduler::work(size_t worker) {
+	size_t seen = 0;
+	while (true) {
+		{
+			std::unique_lock lock(mutex);
+			started.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) return;
+			seen = generation;
+		}
+
+		runRange(worker);
+
+		std::lock_guard lock(mutex);
+		if (--pending == 0)
+			finished.notify_one();
+	}
+}
+
+void RideScheduler::runRange(size_t worker) {
+	size_t workers = stats.size();
+	size_t begin = rideCount * worker / workers, end = rideCount * (worker + 1) / workers;
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t ride = begin; ride < end; ++ride)
+		(*stepRide)(ride);
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	WorkerStats& worked = stats[worker];
+	worked.rides = end - begin;
+	worked.lastMilliseconds = milliseconds;
+	worked.maxMilliseconds = std::max(worked.maxMilliseconds, milliseconds);
+	worked.totalMilliseconds += milliseconds;
+}
+
+// The rides handed out here must not touch each other; whatever they share, like the Tracks,
+// is only read while the tick runs.
+void RideScheduler::tick(size_t rideCount, const std::function<void(size_t ride)>& stepRide) {
+	{
+		std::lock_guard lock(mutex);
+		this->rideCount = rideCount;
+		this->stepRide = &stepRide;
+		pending = threads.size();
+		generation++;
+	}
+	started.notify_all();
+
+	runRange(0);
+
+	std::unique_lock lock(mutex);
+	finished.wait(lock, [&] { return pending == 0; });
+	this->stepRide = nullptr;
+	ticks++;
+}
+
+size_t RideScheduler::getWorkerCount() const {
+	return stats.size();
+}
+
+size_t RideScheduler::getTickCount() const {
+	return ticks;
+}
+
+const std::vector<RideScheduler::WorkerStats>& RideScheduler::getWorkerStats() const {
+	return stats;
+}
+
+void RideScheduler::resetStats() {
+	std::fill(stats.begin(), stats.end(), WorkerStats());
+	ticks = 0;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+// Steps independent rides on a fixed pool of worker threads. Every tick splits the rides into one
+// contiguous range per worker, the calling thread taking the first, and only returns once all of
+// them have stepped, so anything read between ticks sees every ride at the same step.
+class RideScheduler {
+public:
+	// Each worker writes only its own entry, padded to a cache line so they don't share one.
+	struct alignas(64) WorkerStats {
+		size_t rides = 0;
+		double lastMilliseconds = 0.0, maxMilliseconds = 0.0, totalMilliseconds = 0.0;
+	};
+
+private:
+	std::vector<std::thread> threads;
+	std::vector<WorkerStats> stats;
+	std::mutex mutex;
+	std::condition_variable started, finished;
+	const std::function<void(size_t)>* stepRide = nullptr;
+	size_t rideCount = 0, generation = 0, pending = 0, ticks = 0;
+	bool stopping = false;
+
+	void work(size_t worker);
+	void runRange(size_t worker);
+
+public:
+	explicit RideScheduler(size_t workerCount = std::thread::hardware_concurrency());
+	~RideScheduler();
+	RideScheduler(const RideScheduler&) = delete;
+	RideScheduler& operator=(const RideScheduler&) = delete;
+
+	void tick(size_t rideCount, const std::function<void(size_t ride)>& stepRide);
+
+	size_t getWorkerCount() const;
+	size_t getTickCount() const;
+	const std::vector<WorkerStats>& getWorkerStats() const;
+	void resetStats();
+};
\ No newline at end of file
@@ -0,0 +1,555 @@
+#include "FleetSimulator.h"
+#include "Park.h"
+#include "Circuit.h"
+#include "InputLog.h"
+#include "TrainPhysics.h"
+#include "TrackBuilder.h"
+#include "TrackIndex.h"
+#include "TrackSpline.h"
+#include "SimdLanes.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <charconv>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+
+namespace {
+	constexpr float DEFAULT_SIMULATION_RATE = 240.0f, DEFAULT_LOADING_TIME = 30.0f;
+	constexpr float MAX_RIDE_DURATION = 3600.0f;
+	constexpr int NAME_WIDTH = 22, VALUE_WIDTH = 12;
+	constexpr int FLEET_DISPATCH_WAVE = 600, FLEET_SICK_EVERY = 7;
+	constexpr double FLEET_DISPATCH_SPACING = 0.1, FLEET_FIRST_SICK_TIME = 1.0, FLEET_SICK_SPACING = 0.37;
+	constexpr int GAME_TRAIN_COUNT = 3, PARK_STEPS_PER_FRAME = 4, PARK_WARMUP_FRAMES = 600, PARK_FRAMES = 3600;
+	constexpr int CIRCUIT_STEPS_PER_FRAME = 4, CIRCUIT_WARMUP_FRAMES = 3600, CIRCUIT_FRAMES = 36000;
+	constexpr int SPLINE_LOOKUPS = 1000000;
+	constexpr float SPLINE_SEARCH_RANGE = 8.0f, SPLINE_COARSE_STEP = 0.25f, SPLINE_FINE_STEP = 0.005f;
+
+	const std::array<const char*, 5> MODE_NAMES = { "WAITING", "RUNNING", "EMERGENCY_STOP", "SICK_MODE", "FINISHED" };
+
+	struct Ride {
+		float duration = 0.0f, maxSpeed = 0.0f, meanSpeed = 0.0f;
+		std::array<float, MODE_NAMES.size()> modeTime{};
+	};
+
+	int usage() {
+		std::cerr << "usage: smrtovlak-ride <file.track> [--rate <hz>] [--loading <seconds>] [--sick <seconds>] [--rides <count>] [--cars <count>] [--fleet <trains>] [--trains <max>] [--car-sweep] [--park <rides>] [--spline <control points>] [--replay <log>]" << std::endl;
+		return 2;
+	}
+
+	template<typename T>
+	bool parseNumber(const char* text, T& value) {
+		const char* end = text + std::strlen(text);
+		auto [ptr, error] = std::from_chars(text, end, value);
+		return error == std::errc() && ptr == end;
+	}
+
+	template<typename Step>
+	double measure(Step&& step) {
+		auto start = std::chrono::steady_clock::now();
+		step();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void printRow(const std::string& name, const auto& value) {
+		std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << std::setw(VALUE_WIDTH) << value << "\n";
+	}
+
+	// One dispatch of the player's train, stepped exactly like Train::update does, with a rider
+	// getting sick sickTime seconds after the launch when sickTime is not negative.
+	Ride simulateRide(const SpeedProfile& speedProfile, float totalLength, float step, float sickTime) {
+		Ride ride;
+		TrainState train = TrainPhysics::atStation();
+		train.mode = TrainMode::RUNNING;
+
+		double distance = 0.0;
+		for (int tick = 0; tick * step < MAX_RIDE_DURATION; ++tick) {
+			if (sickTime >= 0.0f && train.mode == TrainMode::RUNNING && tick * step >= sickTime)
+				TrainPhysics::emergencyStop(train, totalLength);
+
+			ride.modeTime[int(train.mode)] += step;
+			TrainState next = TrainPhysics::step(train, speedProfile, totalLength, step);
+			if (next.mode == TrainMode::FINISHED) break;
+
+			ride.maxSpeed = std::max(ride.maxSpeed, next.currentSpeed);
+			distance += next.currentSpeed * step;
+			train = next;
+		}
+
+		for (float time : ride.modeTime)
+			ride.duration += time;
+		if (ride.duration > 0.0f)
+			ride.meanSpeed = float(distance / ride.duration);
+		return ride;
+	}
+
+	struct FleetRun {
+		double fleetSeconds = 0.0, scalarSeconds = 0.0;
+		size_t trainSteps = 0, mismatches = 0;
+	};
+
+	bool sameTrain(const TrainState& a, const TrainState& b) {
+		return a.offset == b.offset && a.currentSpeed == b.currentSpeed && a.preStopSpeed == b.preStopSpeed && a.stopDistance == b.stopDistance
+			&& a.rideTime == b.rideTime && a.sleepTimer == b.sleepTimer && a.mode == b.mode;
+	}
+
+	// The same rides stepped in lockstep by FleetSimulator and by TrainPhysics::step one train at a
+	// time, the way FleetSimulator::update does it, until every train is back. Dispatches come in
+	// waves and every FLEET_SICK_EVERY-th ride gets a sick rider at a different point of the ride.
+	// Stops in the first and last second are left out: a train that is barely moving when it stops
+	// never creeps on to the station, in the game as much as here.
+	FleetRun runFleet(const SpeedProfile& speedProfile, float totalLength, float step, int trainCount) {
+		FleetSimulator fleet(speedProfile, totalLength);
+		std::vector<TrainState> trains(trainCount, TrainPhysics::atStation());
+		std::vector<double> dispatchTimes(trainCount), sickTimes(trainCount, -1.0), finishTimes(trainCount, -1.0);
+		for (int i = 0; i < trainCount; ++i) {
+			dispatchTimes[i] = (i % FLEET_DISPATCH_WAVE) * FLEET_DISPATCH_SPACING;
+			if (i % FLEET_SICK_EVERY == 0)
+				sickTimes[i] = dispatchTimes[i] + FLEET_FIRST_SICK_TIME + std::fmod(i * FLEET_SICK_SPACING, speedProfile.duration() - 2.0 * FLEET_FIRST_SICK_TIME);
+			fleet.addRide(dispatchTimes[i], sickTimes[i]);
+		}
+
+		FleetRun run;
+		double clock = 0.0;
+		size_t active = trainCount;
+		while (active > 0 && clock < MAX_RIDE_DURATION) {
+			run.fleetSeconds += measure([&] { fleet.update(step); }) / 1000.0;
+			run.scalarSeconds += measure([&] {
+				for (int i = 0; i < trainCount; ++i) {
+					TrainState& train = trains[i];
+					if (train.mode == TrainMode::WAITING && clock >= dispatchTimes[i]) {
+						train.mode = TrainMode::RUNNING;
+						train.rideTime = 0.0f;
+					}
+					if (train.mode == TrainMode::RUNNING && sickTimes[i] >= 0.0 && clock >= sickTimes[i])
+						TrainPhysics::emergencyStop(train, totalLength);
+					if (train.mode == TrainMode::WAITING || train.mode == TrainMode::FINISHED)
+						continue;
+
+					TrainState next = TrainPhysics::step(train, speedProfile, totalLength, step);
+					if (next.mode == TrainMode::FINISHED) {
+						train = TrainPhysics::atStation();
+						train.mode = TrainMode::FINISHED;
+						finishTimes[i] = clock;
+					} else {
+						train = next;
+					}
+				}
+			}) / 1000.0;
+			clock += step;
+			run.trainSteps += trainCount;
+
+			active = 0;
+			for (int i = 0; i < trainCount; ++i) {
+				if (!sameTrain(fleet.getTrain(i), trains[i]) || fleet.getFinishTime(i) != finishTimes[i])
+					run.mismatches++;
+				if (trains[i].mode != TrainMode::FINISHED)
+					active++;
+			}
+		}
+		return run;
+	}
+
+	struct Replay {
+		double seconds = 0.0;
+		size_t mismatches = 0;
+	};
+
+	// Steps the whole log the way Smrtovlak::step does, as fast as the ride runs and without a frame to draw.
+	Replay runReplay(InputLog& log, const TrackIndex& index) {
+		float step = log.getSimulationStep();
+		Circuit circuit(step, log.getTrainCount(), log.getCarCount(), log.getSeed());
+		circuit.trackChanged(index.length(), [&](float distance) { return index.pitchAt(distance); });
+
+		Replay replay;
+		replay.seconds = measure([&] {
+			while (!log.isFinished()) {
+				RideInput input;
+				while (log.popInput(input))
+					circuit.press(input);
+
+				circuit.update(step);
+				if (circuit.getMode() == TrainMode::FINISHED)
+					circuit.setMode(TrainMode::WAITING);
+				log.stepped(circuit.getStateHash());
+			}
+		}) / 1000.0;
+		replay.mismatches = log.getMismatchCount();
+		return replay;
+	}
+
+	struct CircuitCost {
+		double updateMicroseconds = 0.0, poseMicroseconds = 0.0;
+		size_t posesPerFrame = 0;
+		int runningTrains = 0;
+	};
+
+	// One circuit run the way the game runs it, with riders that board on their own: the cost of a
+	// simulation step and of looking up every car pose for a frame, which is all a frame draws from.
+	CircuitCost measureCircuit(const TrackIndex& index, float step, int trainCount, int carCount) {
+		Circuit circuit(step, trainCount, carCount, std::uint32_t(trainCount));
+		circuit.trackChanged(index.length(), [&](float distance) { return index.pitchAt(distance); });
+		std::vector<float> distances;
+		std::vector<TrackPose> poses;
+
+		CircuitCost cost;
+		double updateTime = 0.0, poseTime = 0.0;
+		size_t poseCount = 0;
+		for (int frame = 0; frame < CIRCUIT_WARMUP_FRAMES + CIRCUIT_FRAMES; ++frame) {
+			double update = measure([&] {
+				for (int i = 0; i < CIRCUIT_STEPS_PER_FRAME; ++i) {
+					circuit.boardAll();
+					circuit.update(step);
+					if (circuit.getMode() == TrainMode::FINISHED)
+						circuit.setMode(TrainMode::WAITING);
+				}
+			});
+			double pose = measure([&] {
+				circuit.interpolate(1.0f);
+				circuit.getCarDistances(distances);
+				poses.resize(distances.size());
+				index.poseAt(distances, poses);
+			});
+			if (frame < CIRCUIT_WARMUP_FRAMES) continue;
+
+			updateTime += update;
+			poseTime += pose;
+			poseCount += poses.size();
+		}
+
+		cost.updateMicroseconds = updateTime * 1000.0 / (double(CIRCUIT_FRAMES) * CIRCUIT_STEPS_PER_FRAME);
+		cost.poseMicroseconds = poseTime * 1000.0 / CIRCUIT_FRAMES;
+		cost.posesPerFrame = poseCount / CIRCUIT_FRAMES;
+		cost.runningTrains = std::min(trainCount, TrainPhysics::maxRunningTrains(index.length(), carCount));
+		return cost;
+	}
+
+	// 1, 10, 100... trains up to maxTrains on one circuit. Only as many as the blocks allow run at
+	// once; the rest wait in storage, so this shows what the trains that don't move still cost.
+	void reportTrains(const TrackIndex& index, float step, int maxTrains, int carCount) {
+		for (int trains = 1; trains <= maxTrains; trains *= 10) {
+			CircuitCost cost = measureCircuit(index, step, trains, carCount);
+			std::cout << "\n";
+			printRow("trains", trains);
+			printRow("running at once", cost.runningTrains);
+			printRow("update (us/step)", cost.updateMicroseconds);
+			printRow("poses (us/frame)", cost.poseMicroseconds);
+			printRow("car poses/frame", cost.posesPerFrame);
+			if (trains > maxTrains / 10) break;
+		}
+	}
+
+	// The game's three trains with 2, 4, 8... cars up to the longest train allowed. Drawing needs GL,
+	// so the game times it when it replays a log; here the frame cost is the car poses it draws from.
+	void reportCarSweep(const TrackIndex& index, float step) {
+		for (int cars = TrainPhysics::MIN_CAR_COUNT; cars <= TrainPhysics::MAX_CAR_COUNT; cars *= 2) {
+			CircuitCost cost = measureCircuit(index, step, GAME_TRAIN_COUNT, cars);
+			std::cout << "\n";
+			printRow("cars", cars);
+			printRow("running at once", cost.runningTrains);
+			printRow("update (us/step)", cost.updateMicroseconds);
+			printRow("poses (us/frame)", cost.poseMicroseconds);
+			printRow("car poses/frame", cost.posesPerFrame);
+		}
+	}
+
+	bool reportFleet(const SpeedProfile& speedProfile, float totalLength, float step, int trainCount) {
+		FleetRun fleet = runFleet(speedProfile, totalLength, step, trainCount);
+		std::cout << "\n";
+		printRow("fleet trains", trainCount);
+		printRow("SIMD lanes", SimdLanes::WIDTH);
+		printRow("train-steps", fleet.trainSteps);
+		printRow("fleet (M steps/s)", fleet.trainSteps / fleet.fleetSeconds / 1e6);
+		printRow("scalar (M steps/s)", fleet.trainSteps / fleet.scalarSeconds / 1e6);
+		printRow("speedup", fleet.scalarSeconds / fleet.fleetSeconds);
+		printRow("mismatches", fleet.mismatches);
+		return fleet.mismatches == 0;
+	}
+
+	// Where on the spline a sample lies: the closest point within a few metres of the same share of the lap,
+	// since the spline is shorter than the jittery sample polyline.
+	float nearestSplineDistance(const TrackSpline& spline, const TrackPoint& point, float scale) {
+		auto search = [&](float center, float range, float step) {
+			float best = center, bestDistance = INFINITY;
+			for (float distance = center - range; distance <= center + range; distance += step) {
+				float clamped = std::clamp(distance, 0.0f, spline.length());
+				float offset = glm::distance(spline.positionAt(clamped), point.center);
+				if (offset < bestDistance) {
+					bestDistance = offset;
+					best = clamped;
+				}
+			}
+			return best;
+			};
+		return search(search(point.distance * scale, SPLINE_SEARCH_RANGE, SPLINE_COARSE_STEP), SPLINE_COARSE_STEP, SPLINE_FINE_STEP);
+	}
+
+	// The optional spline path against the samples it is fitted through: how far it strays from them,
+	// how far its pitch and up vector disagree with the sampled frames, and what a pose lookup costs.
+	void reportSpline(std::span<const TrackPoint> points, const TrackIndex& index, size_t controlPointCount) {
+		TrackSpline spline;
+		double buildTime = measure([&] { spline = TrackSpline(points, controlPointCount); });
+		if (spline.empty()) {
+			std::cerr << "Too few points for a spline with " << controlPointCount << " control points" << std::endl;
+			return;
+		}
+
+		float scale = spline.length() / index.length(), maxOffset = 0.0f, maxPitchAngle = 0.0f, maxUpAngle = 0.0f;
+		for (const TrackPoint& point : points) {
+			TrackPose pose = spline.poseAt(nearestSplineDistance(spline, point, scale));
+			glm::vec3 up = point.orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+			maxOffset = std::max(maxOffset, glm::distance(pose.position, point.center));
+			maxPitchAngle = std::max(maxPitchAngle, glm::degrees(std::abs(pose.pitch - point.pitch)));
+			maxUpAngle = std::max(maxUpAngle, glm::degrees(std::acos(std::clamp(glm::dot(pose.up, up), -1.0f, 1.0f))));
+		}
+
+		volatile float sink = 0.0f;
+		double indexTime = measure([&] {
+			for (int i = 0; i < SPLINE_LOOKUPS; ++i)
+				sink = index.poseAt(index.length() * i / SPLINE_LOOKUPS).position.y;
+		});
+		double splineTime = measure([&] {
+			for (int i = 0; i < SPLINE_LOOKUPS; ++i)
+				sink = spline.poseAt(spline.length() * i / SPLINE_LOOKUPS).position.y;
+		});
+
+		std::cout << "\n";
+		printRow("spline controls", spline.controlPointCount());
+		printRow("spline build (ms)", buildTime);
+		printRow("spline length (m)", spline.length());
+		printRow("sample length (m)", index.length());
+		printRow("max offset (m)", maxOffset);
+		printRow("max pitch gap (deg)", maxPitchAngle);
+		printRow("max up angle (deg)", maxUpAngle);
+		printRow("sample pose (ns)", indexTime * 1e6 / SPLINE_LOOKUPS);
+		printRow("spline pose (ns)", splineTime * 1e6 / SPLINE_LOOKUPS);
+	}
+
+	// A park of rideCount rides with the game's three trains, stepped at the game's frame budget on one
+	// worker, then on twice as many up to the core count, with the car poses of every ride looked up each frame.
+	void reportPark(const TrackIndex& index, float step, int rideCount, int carCount) {
+		Park park(index, step, rideCount, GAME_TRAIN_COUNT, carCount);
+		size_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+		double serialTime = 0.0;
+
+		std::cout << "\n";
+		printRow("park rides", rideCount);
+		for (size_t workers = 1;; workers = std::min(workers * 2, maxWorkers)) {
+			RideScheduler scheduler(workers);
+			for (int frame = 0; frame < PARK_WARMUP_FRAMES; ++frame)
+				park.update(scheduler, PARK_STEPS_PER_FRAME, 1.0f);
+			scheduler.resetStats();
+
+			double frameTime = measure([&] {
+				for (int frame = 0; frame < PARK_FRAMES; ++frame)
+					park.update(scheduler, PARK_STEPS_PER_FRAME, 1.0f);
+			}) / PARK_FRAMES;
+			if (workers == 1)
+				serialTime = frameTime;
+
+			printRow("workers", workers);
+			printRow("frame (ms)", frameTime);
+			printRow("speedup", serialTime / frameTime);
+			printRow("car poses/frame", park.getPoseCount());
+			const auto& stats = scheduler.getWorkerStats();
+			for (size_t worker = 0; worker < stats.size(); ++worker)
+				std::cout << "  worker " << worker << ": " << stats[worker].rides << " rides, " << stats[worker].totalMilliseconds / scheduler.getTickCount()
+					<< " ms/tick mean, " << stats[worker].maxMilliseconds << " ms max\n";
+
+			if (workers == maxWorkers)
+				return;
+		}
+	}
+
+	struct SickWhileHeld {
+		bool held = false, back = false;
+		float returnTime = 0.0f;
+	};
+
+	// Rides the game's circuit with riders that board on their own until the player's train is held at
+	// the end of a block, then makes the rider in the first seat sick the way its key would, and times
+	// how long the train takes to get back to the station. A standing train must not stay in its emergency stop.
+	SickWhileHeld sickWhileHeld(const TrackIndex& index, float step, int carCount) {
+		Circuit circuit(step, GAME_TRAIN_COUNT, carCount, std::uint32_t(GAME_TRAIN_COUNT));
+		circuit.trackChanged(index.length(), [&](float distance) { return index.pitchAt(distance); });
+		auto onCircuit = [&] {
+			TrainMode mode = circuit.getMode();
+			return mode == TrainMode::RUNNING || mode == TrainMode::EMERGENCY_STOP || mode == TrainMode::SICK_MODE;
+			};
+
+		// Train 0 is the one carrying the riders.
+		SickWhileHeld result;
+		for (float time = 0.0f; time < MAX_RIDE_DURATION && !result.held; time += step) {
+			circuit.boardAll();
+			float offset = circuit.getTrain(0).offset;
+			circuit.update(step);
+			if (circuit.getMode() == TrainMode::FINISHED)
+				circuit.setMode(TrainMode::WAITING);
+			const TrainState& train = circuit.getTrain(0);
+			result.held = train.mode == TrainMode::RUNNING && train.rideTime > 0.0f && train.offset == offset;
+		}
+		if (!result.held)
+			return result;
+
+		circuit.press(RideInput::SEAT_1);
+		while (result.returnTime < MAX_RIDE_DURATION && !result.back) {
+			circuit.update(step);
+			result.returnTime += step;
+			result.back = !onCircuit();
+		}
+		return result;
+	}
+
+	// The shortest time between two dispatches that never holds the second train: how long each
+	// block stays occupied from the moment the front enters until the tail has left it. The block
+	// with the platform is left out, it only ever holds the train that is loading.
+	float minDispatchInterval(const SpeedProfile& speedProfile, float totalLength, int carCount) {
+		int blockCount = TrainPhysics::blockCount(totalLength, carCount);
+		float blockLength = totalLength / blockCount, interval = 0.0f;
+		for (int block = 0; block + 1 < blockCount; ++block) {
+			float start = TrainPhysics::START_OFFSET + block * blockLength;
+			float entered = speedProfile.timeAtDistance(start);
+			float cleared = speedProfile.timeAtDistance(start + blockLength + TrainPhysics::length(carCount));
+			interval = std::max(interval, cleared - entered);
+		}
+		return interval;
+	}
+}
+
+// Rides the train on the given track at a fixed timestep without a window or GL context and
+// reports the ride and the capacity it allows, so layouts can be compared on a build machine.
+int main(int argc, char** argv) {
+	std::string trackPath, replayPath;
+	bool carSweep = false;
+	float rate = DEFAULT_SIMULATION_RATE, loadingTime = DEFAULT_LOADING_TIME, sickTime = -1.0f;
+	int rides = 1, carCount = TrainPhysics::DEFAULT_CAR_COUNT, fleetTrains = 0, maxTrains = 0, parkRides = 0;
+	size_t splineControlPoints = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		bool valid = true;
+		if (arg == "--rate" && hasValue) valid = parseNumber(argv[++i], rate) && rate > 0.0f;
+		else if (arg == "--loading" && hasValue) valid = parseNumber(argv[++i], loadingTime) && loadingTime >= 0.0f;
+		else if (arg == "--sick" && hasValue) valid = parseNumber(argv[++i], sickTime) && sickTime >= 0.0f;
+		else if (arg == "--rides" && hasValue) valid = parseNumber(argv[++i], rides) && rides > 0;
+		else if (arg == "--cars" && hasValue) valid = parseNumber(argv[++i], carCount) && carCount >= TrainPhysics::MIN_CAR_COUNT && carCount <= TrainPhysics::MAX_CAR_COUNT;
+		else if (arg == "--fleet" && hasValue) valid = parseNumber(argv[++i], fleetTrains) && fleetTrains > 0;
+		else if (arg == "--car-sweep") carSweep = true;
+		else if (arg == "--trains" && hasValue) valid = parseNumber(argv[++i], maxTrains) && maxTrains > 0;
+		else if (arg == "--park" && hasValue) valid = parseNumber(argv[++i], parkRides) && parkRides > 0;
+		else if (arg == "--spline" && hasValue) valid = parseNumber(argv[++i], splineControlPoints) && splineControlPoints >= 4;
+		else if (arg == "--replay" && hasValue) replayPath = argv[++i];
+		else if (trackPath.empty() && !arg.starts_with("-")) trackPath = arg;
+		else valid = false;
+		if (!valid) return usage();
+	}
+	if (trackPath.empty()) return usage();
+
+	InputLog replayLog;
+	if (!replayPath.empty() && !replayLog.load(replayPath))
+		return 1;
+
+	TrackBuilder builder;
+	double loadTime = measure([&] { builder = TrackBuilder::pointsOnly(trackPath); });
+	std::span<const TrackPoint> points = builder.getPoints();
+	if (points.size() < 2) {
+		std::cerr << "No track points in " << trackPath << std::endl;
+		return 1;
+	}
+
+	TrackIndex index(points);
+	index.rebuild();
+	float step = 1.0f / rate, totalLength = index.length();
+
+	// A replay runs the ride the log was recorded with, so its own step, train and car counts win over the options.
+	if (!replayPath.empty()) {
+		Replay replay = runReplay(replayLog, index);
+		std::cout << std::fixed << std::setprecision(3);
+		printRow("track", trackPath);
+		printRow("replay", replayPath);
+		printRow("rate (Hz)", 1.0f / replayLog.getSimulationStep());
+		printRow("trains", replayLog.getTrainCount());
+		printRow("cars", replayLog.getCarCount());
+		printRow("steps", replayLog.getTick());
+		printRow("ride time (s)", replayLog.getTick() * replayLog.getSimulationStep());
+		printRow("replay (ms)", replay.seconds * 1000.0);
+		printRow("steps/s", replayLog.getTick() / replay.seconds);
+		printRow("mismatches", replay.mismatches);
+		if (replay.mismatches > 0)
+			printRow("first mismatch", replayLog.getFirstMismatch());
+		return replay.mismatches == 0 ? 0 : 1;
+	}
+
+	SpeedProfile speedProfile;
+	double profileTime = measure([&] {
+		speedProfile = TrainPhysics::buildSpeedProfile(totalLength, [&](float distance) { return index.pitchAt(distance); }, step, carCount);
+	});
+
+	Ride ride;
+	double rideTime = measure([&] {
+		for (int i = 0; i < rides; ++i)
+			ride = simulateRide(speedProfile, totalLength, step, sickTime);
+	}) / rides;
+
+	int seats = carCount * Circuit::SEATS_PER_CAR;
+	float cycle = ride.duration + loadingTime;
+	float interval = std::max(loadingTime, minDispatchInterval(speedProfile, totalLength, carCount));
+	if (TrainPhysics::maxRunningTrains(totalLength, carCount) == 1)
+		interval = cycle;
+
+	std::cout << std::fixed << std::setprecision(3);
+	printRow("track", trackPath);
+	printRow("length (m)", totalLength);
+	printRow("rate (Hz)", rate);
+	printRow("cars", carCount);
+	printRow("blocks", TrainPhysics::blockCount(totalLength, carCount));
+
+	std::cout << "\n";
+	printRow("ride duration (s)", ride.duration);
+	printRow("max speed (m/s)", ride.maxSpeed);
+	printRow("mean speed (m/s)", ride.meanSpeed);
+	for (size_t mode = 0; mode < MODE_NAMES.size(); ++mode)
+		if (ride.modeTime[mode] > 0.0f)
+			printRow(std::string(MODE_NAMES[mode]) + " (s)", ride.modeTime[mode]);
+
+	std::cout << "\n";
+	printRow("loading time (s)", loadingTime);
+	printRow("seats", seats);
+	printRow("riders/h, 1 train", seats * 3600.0f / cycle);
+	printRow("dispatch interval (s)", interval);
+	printRow("trains needed", int(std::ceil(cycle / interval)));
+	printRow("riders/h, blocks", seats * 3600.0f / interval);
+
+	std::cout << "\n";
+	printRow("load track (ms)", loadTime);
+	printRow("speed profile (ms)", profileTime);
+	printRow(rides > 1 ? "ride (mean ms)" : "ride (ms)", rideTime);
+
+	bool passed = true;
+	SickWhileHeld sick = sickWhileHeld(index, step, carCount);
+	if (sick.held) {
+		std::cout << "\n";
+		if (sick.back)
+			printRow("sick while held (s)", sick.returnTime);
+		else
+			printRow("sick while held", "stuck");
+		passed &= sick.back;
+	}
+	if (fleetTrains > 0)
+		passed &= reportFleet(speedProfile, totalLength, step, fleetTrains);
+	if (maxTrains > 0)
+		reportTrains(index, step, maxTrains, carCount);
+	if (carSweep)
+		reportCarSweep(index, step);
+	if (parkRides > 0)
+		reportPark(index, step, parkRides, carCount);
+	if (splineControlPoints > 0)
+		reportSpline(points, index, splineControlPoints);
+	return passed ? 0 : 1;
+}
\ No newline at end of file
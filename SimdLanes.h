@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+// SSE2 is part of every x64 CPU, and MSVC only says so through _M_X64 or _M_IX86_FP.
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
+
+// Each Lanes type wraps one register width behind the same handful of operations, so the
+// lookup kernels are written once and instantiated for AVX2, SSE2 and plain floats. AVX2 is
+// only used when the whole build targets it, so the default builds run on any x64 CPU.
+struct ScalarLanes {
+	static constexpr size_t WIDTH = 1;
+	using Float = float;
+	using Int = int;
+	using Mask = bool;
+
+	static Float load(const float* p) { return *p; }
+	static void store(float* p, Float v) { *p = v; }
+	static Float splat(float v) { return v; }
+	static Int splatInt(int v) { return v; }
+	static Float gather(const std::vector<float>& column, Int index) { return column[index]; }
+	static Float add(Float a, Float b) { return a + b; }
+	static Float sub(Float a, Float b) { return a - b; }
+	static Float mul(Float a, Float b) { return a * b; }
+	static Float div(Float a, Float b) { return a / b; }
+	static Float sqrt(Float a) { return std::sqrt(a); }
+	static Float clamp01(Float a) { return std::clamp(a, 0.0f, 1.0f); }
+	static Float max(Float a, Float b) { return std::max(a, b); }
+	static Int truncate(Float a) { return int(a); }
+	static Float toFloat(Int a) { return float(a); }
+	static Int addInt(Int a, Int b) { return a + b; }
+	static Int minInt(Int a, Int b) { return std::min(a, b); }
+	static Mask lessEqual(Float a, Float b) { return a <= b; }
+	static Mask greater(Float a, Float b) { return a > b; }
+	static Float select(Mask mask, Float a, Float b) { return mask ? a : b; }
+	static Int selectInt(Mask mask, Int a, Int b) { return mask ? a : b; }
+};
+
+#if defined(__AVX2__)
+struct SimdLanes {
+	static constexpr size_t WIDTH = 8;
+	using Float = __m256;
+	using Int = __m256i;
+	using Mask = __m256;
+
+	static Float load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+	static Float splat(float v) { return _mm256_set1_ps(v); }
+	static Int splatInt(int v) { return _mm256_set1_epi32(v); }
+	static Float gather(const std::vector<float>& column, Int index) { return _mm256_i32gather_ps(column.data(), index, 4); }
+	static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+	static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+	static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+	static Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+	static Float sqrt(Float a) { return _mm256_sqrt_ps(a); }
+	static Float clamp01(Float a) { return _mm256_min_ps(_mm256_max_ps(a, _mm256_setzero_ps()), _mm256_set1_ps(1.0f)); }
+	static Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+	static Int truncate(Float a) { return _mm256_cvttps_epi32(a); }
+	static Float toFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+	static Int addInt(Int a, Int b) { return _mm256_add_epi32(a, b); }
+	static Int minInt(Int a, Int b) { return _mm256_min_epi32(a, b); }
+	static Mask lessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static Mask greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Float select(Mask mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+	static Int selectInt(Mask mask, Int a, Int b) { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), mask)); }
+};
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+struct SimdLanes {
+	static constexpr size_t WIDTH = 4;
+	using Float = __m128;
+	using Int = __m128i;
+	using Mask = __m128;
+
+	static Float load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, Float v) { _mm_storeu_ps(p, v); }
+	static Float splat(float v) { return _mm_set1_ps(v); }
+	static Int splatInt(int v) { return _mm_set1_epi32(v); }
+	static Float gather(const std::vector<float>& column, Int index) {
+		alignas(16) int lanes[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+		const float* base = column.data();
+		return _mm_setr_ps(base[lanes[0]], base[lanes[1]], base[lanes[2]], base[lanes[3]]);
+	}
+	static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+	static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+	static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+	static Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+	static Float sqrt(Float a) { return _mm_sqrt_ps(a); }
+	static Float clamp01(Float a) { return _mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(1.0f)); }
+	static Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+	static Int truncate(Float a) { return _mm_cvttps_epi32(a); }
+	static Float toFloat(Int a) { return _mm_cvtepi32_ps(a); }
+	static Int addInt(Int a, Int b) { return _mm_add_epi32(a, b); }
+	static Int minInt(Int a, Int b) { return selectInt(_mm_castsi128_ps(_mm_cmplt_epi32(a, b)), a, b); }
+	static Mask lessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+	static Mask greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+	// The masks are whole lanes of ones or zeros, so and/andnot/or blends like SSE4.1's blendv.
+	static Float select(Mask mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+	static Int selectInt(Mask mask, Int a, Int b) { return _mm_castps_si128(select(mask, _mm_castsi128_ps(a), _mm_castsi128_ps(b))); }
+};
+#else
+using SimdLanes = ScalarLanes;
+#endif
\ No newline at end of file
@@ -1,20 +1,43 @@
 ﻿#include "Smrtovlak.h"
+#include <iostream>
+#include <random>
 #include <thread>
 #include <chrono>
+#include <cmath>
 
 namespace {
 	constexpr float LIGHT_X = 30.0f, LIGHT_Y = 50.0f, LIGHT_Z = 5.0f;
 	constexpr glm::vec3 SKY_COLOR = glm::vec3(95, 188, 235) / 255.0f;
 	constexpr glm::vec3	LIGHT_COLOR(1.0f, 0.95f, 0.6f);
+	const std::string TRACK_PATH = "smrtovlak.track";
+
+	constexpr float SIMULATION_STEP = 1.0f / 240.0f;
+	constexpr int MAX_CATCH_UP_STEPS = 30;
+	constexpr int TRAIN_COUNT = 3;
+	constexpr int REPLAY_STEPS_PER_FRAME = 4;
+
+	// Keys 1-8 reach the seats of the current page; Tab moves to the next eight seats.
+	bool toRideInput(int key, RideInput& input) {
+		if (key >= GLFW_KEY_1 && key <= GLFW_KEY_8) input = RideInput(int(RideInput::SEAT_1) + key - GLFW_KEY_1);
+		else if (key == GLFW_KEY_TAB) input = RideInput::NEXT_SEAT_PAGE;
+		else if (key == GLFW_KEY_SPACE) input = RideInput::ADD_RIDER;
+		else if (key == GLFW_KEY_ENTER) input = RideInput::START;
+		else return false;
+		return true;
+	}
 }
 
-Smrtovlak::Smrtovlak()
+Smrtovlak::Smrtovlak(int carCount, size_t splineControlPoints, const std::string& recordPath, InputLog replayLog)
 	: window(1280, 800, 800, 600, "Smrtovlak 3D", "assets/icons/icon.png", true),
 	text(window, L"Momir Stanišić SV39/2022", Bounds(46, 68, 18)),
 	shader("shaders/3d.vert", "shaders/3d.frag"),
 	ground("assets/textures/grass.jpg"),
-	tracks("smrtovlak.track"),
-	train(tracks) {
+	tracks(TRACK_PATH, Tracks::DEFAULT_SIMPLIFY_TOLERANCE, splineControlPoints),
+	trackWatcher(TRACK_PATH),
+	inputLog(std::move(replayLog)),
+	seed(openInputLog(recordPath, carCount)),
+	train(tracks, SIMULATION_STEP, inputLog.isReplaying() ? inputLog.getTrainCount() : TRAIN_COUNT,
+		inputLog.isReplaying() ? inputLog.getCarCount() : carCount, seed) {
 
 	glClearColor(SKY_COLOR.r, SKY_COLOR.g, SKY_COLOR.b, 1.0f);
 
@@ -25,36 +48,46 @@ Smrtovlak::Smrtovlak()
 	glfwSetInputMode(window.getWindow(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 }
 
+// Runs before train is constructed, so the riders are shuffled with the seed of the log being replayed
+// and the train gets the train and car counts it was recorded with.
+std::uint32_t Smrtovlak::openInputLog(const std::string& recordPath, int carCount) {
+	if (inputLog.isReplaying())
+		return inputLog.getSeed();
+
+	std::uint32_t seed = std::random_device()();
+	if (!recordPath.empty())
+		inputLog.record(recordPath, seed, carCount, TRAIN_COUNT, SIMULATION_STEP);
+	return seed;
+}
+
+// While replaying, only the inputs from the log reach the ride; the window still handles its own.
+// The camera is not part of the ride and is never recorded.
 void Smrtovlak::keyboardCallback(GLFWwindow& win, int key, int scancode, int action, int mods) {
-	if (action != GLFW_PRESS) return;
-
-	CameraMode cameraMode = camera.getMode();
-	TrainMode trainMode = train.getMode();
-
-	if (key >= GLFW_KEY_1 && key <= GLFW_KEY_8) {
-		if (trainMode == TrainMode::WAITING) {
-			train.buckleUp(key - GLFW_KEY_1);
-		} else if (trainMode == TrainMode::RUNNING) {
-			train.makeSick(key - GLFW_KEY_1);
-			if (key - GLFW_KEY_1 == 0)
-				greenTintEnabled = true;
-		}
-	} else if (key == GLFW_KEY_SPACE && trainMode == TrainMode::WAITING) {
-		if (cameraMode == CameraMode::GroundLevel)
-			camera.setMode(CameraMode::FollowTrain);
-		train.addCharacter();
+	if (action != GLFW_PRESS || inputLog.isReplaying()) return;
+
+	RideInput input;
+	if (toRideInput(key, input)) {
+		inputLog.pressed(input);
+		handleInput(input);
 	} else if (key == GLFW_KEY_E) {
-		if (cameraMode != CameraMode::FreeFly)
+		if (camera.getMode() != CameraMode::FreeFly)
 			camera.setMode(CameraMode::FreeFly);
 		else if (train.getCharactersCount() > 0)
 			camera.setMode(CameraMode::FollowTrain);
 		else
 			camera.setMode(CameraMode::GroundLevel);
-	} else if (key == GLFW_KEY_ENTER && trainMode == TrainMode::WAITING) {
-		train.start();
 	}
 }
 
+void Smrtovlak::handleInput(RideInput input) {
+	if (input == RideInput::ADD_RIDER && train.getMode() == TrainMode::WAITING && camera.getMode() == CameraMode::GroundLevel)
+		camera.setMode(CameraMode::FollowTrain);
+
+	train.press(input);
+	if (train.getSeats()[0].sick)
+		greenTintEnabled = true;
+}
+
 void Smrtovlak::draw() {
 	bool cameraInTrain = camera.getMode() == CameraMode::FollowTrain;
 
@@ -68,10 +101,11 @@ void Smrtovlak::draw() {
 	int height = window.getHeight();
 	float aspect = (height == 0) ? 1.0f : (float)window.getWidth() / height;
 	glm::vec3 viewPos = camera.getPosition();
+	glm::mat4 view = camera.view(), projection = camera.projection(aspect);
 
 	shader.use();
-	shader.setMat4("view", &camera.view()[0][0]);
-	shader.setMat4("projection", &camera.projection(aspect)[0][0]);
+	shader.setMat4("view", &view[0][0]);
+	shader.setMat4("projection", &projection[0][0]);
 
 	shader.setVec3("lightColor", LIGHT_COLOR.r, LIGHT_COLOR.g, LIGHT_COLOR.b);
 	shader.setVec3("lightPos", LIGHT_X, LIGHT_Y, LIGHT_Z);
@@ -81,8 +115,11 @@ void Smrtovlak::draw() {
 	shader.setVec2("resolution", (float)window.getWidth(), (float)window.getHeight());
 
 	ground.draw(shader);
-	tracks.draw(shader);
+	tracks.draw(shader, projection * view);
+	auto trainStart = std::chrono::high_resolution_clock::now();
 	train.draw(shader, cameraInTrain);
+	trainDrawMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - trainStart).count();
+	drawnFrames++;
 
 	text.draw();
 
@@ -91,6 +128,11 @@ void Smrtovlak::draw() {
 }
 
 int Smrtovlak::run() {
+	if (inputLog.isReplaying() && inputLog.getSimulationStep() != SIMULATION_STEP) {
+		std::cerr << "Input log was recorded at " << 1.0f / inputLog.getSimulationStep() << " Hz, the game steps at " << 1.0f / SIMULATION_STEP << " Hz" << std::endl;
+		return 1;
+	}
+
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LESS);
 
@@ -101,20 +143,36 @@ int Smrtovlak::run() {
 	glClearColor(SKY_COLOR.r, SKY_COLOR.g, SKY_COLOR.b, 1.0f);
 
 	const double targetFrame = 1.0 / 75.0;
-	auto lastTime = std::chrono::high_resolution_clock::now();
+	auto lastTime = std::chrono::high_resolution_clock::now(), replayStart = lastTime;
+	float accumulator = 0.0f;
 
 	while (!window.shouldClose()) {
 		auto startTime = std::chrono::high_resolution_clock::now();
 		float deltaTime = std::chrono::duration<float>(startTime - lastTime).count();
 		lastTime = startTime;
 
-		train.update(deltaTime);
+		// A replay runs as fast as the frames render; the clock only decides how many steps a frame takes.
+		if (inputLog.isReplaying()) {
+			if (inputLog.isFinished()) break;
+			deltaTime = REPLAY_STEPS_PER_FRAME * SIMULATION_STEP;
+		}
 
-		if (train.getMode() == TrainMode::FINISHED) {
-			train.setMode(TrainMode::WAITING);
-			greenTintEnabled = false;
-			camera.reset();
+		if (trackWatcher.poll())
+			tracks.reload();
+		if (tracks.applyReload())
+			train.trackChanged();
+
+		// The ride advances in fixed steps so it plays out the same at any frame rate; a frame that
+		// falls more than MAX_CATCH_UP_STEPS behind drops the backlog instead of stalling further.
+		accumulator += deltaTime;
+		int steps = 0;
+		for (; accumulator >= SIMULATION_STEP && steps < MAX_CATCH_UP_STEPS; ++steps) {
+			step();
+			accumulator -= SIMULATION_STEP;
 		}
+		if (steps == MAX_CATCH_UP_STEPS)
+			accumulator = std::fmod(accumulator, SIMULATION_STEP);
+		train.interpolate(accumulator / SIMULATION_STEP);
 
 		camera.trainPoint = train.getCameraTransform();
 		camera.update(window.getWindow(), deltaTime);
@@ -124,11 +182,39 @@ int Smrtovlak::run() {
 		auto endTime = std::chrono::high_resolution_clock::now();
 		double elapsed = std::chrono::duration<double>(endTime - startTime).count();
 		double remaining = targetFrame - elapsed;
-		if (remaining > 0)
+		if (remaining > 0 && !inputLog.isReplaying())
 			std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
 	}
 
-	return 0;
+	if (!inputLog.isReplaying())
+		return 0;
+
+	double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - replayStart).count();
+	std::cout << "Replayed " << inputLog.getTick() << " steps in " << seconds << " s (" << inputLog.getTick() / seconds << " steps/s), "
+		<< train.getCarCount() << " cars drawn in " << trainDrawMilliseconds / std::max<size_t>(drawnFrames, 1) << " ms/frame, ";
+	if (inputLog.getMismatchCount() == 0) {
+		std::cout << "every state hash matches" << std::endl;
+		return 0;
+	}
+	std::cout << inputLog.getMismatchCount() << " state hashes differ, the first at step " << inputLog.getFirstMismatch() << std::endl;
+	return 1;
+}
+
+// One fixed simulation step. Everything that changes the ride happens here, inputs from a replay
+// included, so the ride only depends on the order of steps and not on where the frames fall.
+void Smrtovlak::step() {
+	RideInput input;
+	while (inputLog.popInput(input))
+		handleInput(input);
+
+	train.update(SIMULATION_STEP);
+	if (train.getMode() == TrainMode::FINISHED) {
+		train.setMode(TrainMode::WAITING);
+		greenTintEnabled = false;
+		camera.reset();
+	}
+
+	inputLog.stepped(train.getStateHash());
 }
 
 void Smrtovlak::resizeCallback(GLFWwindow&) {
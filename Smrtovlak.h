@@ -1,5 +1,7 @@
 #pragma once
 #include "WindowManager.h"
+#include "FileWatcher.h"
+#include "InputLog.h"
 #include <GLFW/glfw3.h>
 #include "Shader.h"
 #include "Camera.h"
@@ -14,13 +16,22 @@ class Smrtovlak : public ResizeListener, public KeyboardListener {
     Shader shader;
     Ground ground;
     Tracks tracks;
+    FileWatcher trackWatcher;
+    InputLog inputLog;
+    std::uint32_t seed;
     Train train;
     Text text;
 
     bool greenTintEnabled = false;
+    double trainDrawMilliseconds = 0.0;
+    size_t drawnFrames = 0;
+
+    std::uint32_t openInputLog(const std::string& recordPath, int carCount);
+    void handleInput(RideInput input);
+    void step();
 
 public:
-    Smrtovlak();
+    Smrtovlak(int carCount = TrainPhysics::DEFAULT_CAR_COUNT, size_t splineControlPoints = 0, const std::string& recordPath = "", InputLog replayLog = {});
 
     int run();
     void draw();
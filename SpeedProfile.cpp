@@ -0,0 +1,73 @@
+#include "SpeedProfile.h"
+#include <algorithm>
+
+namespace {
+	float sample(const std::vector<float>& column, float step, float time) {
+		float position = std::max(time / step, 0.0f);
+		size_t index = std::min(size_t(position), column.size() - 1);
+		if (index + 1 >= column.size()) return column.back();
+		float t = position - index;
+		return column[index] + (column[index + 1] - column[index]) * t;
+	}
+}
+
+SpeedProfile::SpeedProfile(float step, std::vector<float> distances, std::vector<float> speeds)
+	: step(step), distances(std::move(distances)), speeds(std::move(speeds)) {
+	for (float speed : this->speeds)
+		maxSpeed = std::max(maxSpeed, speed);
+}
+
+bool SpeedProfile::empty() const {
+	return distances.empty();
+}
+
+float SpeedProfile::duration() const {
+	return distances.empty() ? 0.0f : (distances.size() - 1) * step;
+}
+
+float SpeedProfile::getMaxSpeed() const {
+	return maxSpeed;
+}
+
+float SpeedProfile::getStep() const {
+	return step;
+}
+
+const std::vector<float>& SpeedProfile::getDistances() const {
+	return distances;
+}
+
+const std::vector<float>& SpeedProfile::getSpeeds() const {
+	return speeds;
+}
+
+float SpeedProfile::distanceAt(float time) const {
+	return distances.empty() ? 0.0f : sample(distances, step, time);
+}
+
+float SpeedProfile::speedAt(float time) const {
+	return speeds.empty() ? 0.0f : sample(speeds, step, time);
+}
+
+// Distances never decrease over the ride, so the sample for a distance is found by bisection.
+float SpeedProfile::speedAtDistance(float distance) const {
+	if (distances.empty()) return 0.0f;
+	size_t index = std::upper_bound(distances.begin(), distances.end(), distance) - distances.begin();
+	if (index == 0) return speeds.front();
+	if (index == distances.size()) return speeds.back();
+
+	float span = distances[index] - distances[index - 1];
+	float t = span > 0.0f ? (distance - distances[index - 1]) / span : 0.0f;
+	return speeds[index - 1] + (speeds[index] - speeds[index - 1]) * t;
+}
+
+float SpeedProfile::timeAtDistance(float distance) const {
+	if (distances.empty()) return 0.0f;
+	size_t index = std::upper_bound(distances.begin(), distances.end(), distance) - distances.begin();
+	if (index == 0) return 0.0f;
+	if (index == distances.size()) return duration();
+
+	float span = distances[index] - distances[index - 1];
+	float t = span > 0.0f ? (distance - distances[index - 1]) / span : 0.0f;
+	return (index - 1 + t) * step;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+
+// The ride sampled once per simulation step: where the train is and how fast it goes, from the
+// launch until it stops at the station. Running the ride is then a lookup by elapsed time.
+class SpeedProfile {
+	float step = 0.0f, maxSpeed = 0.0f;
+	std::vector<float> distances, speeds;
+
+public:
+	SpeedProfile() = default;
+	SpeedProfile(float step, std::vector<float> distances, std::vector<float> speeds);
+
+	bool empty() const;
+	float duration() const;
+	float getMaxSpeed() const;
+	float getStep() const;
+	const std::vector<float>& getDistances() const;
+	const std::vector<float>& getSpeeds() const;
+
+	float distanceAt(float time) const;
+	float speedAt(float time) const;
+	float speedAtDistance(float distance) const;
+	float timeAtDistance(float distance) const;
+};
\ No newline at end of file
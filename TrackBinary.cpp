@@ -0,0 +1,66 @@
+#include "TrackBinary.h"
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+namespace {
+	constexpr char MAGIC[8] = { 'S', 'M', 'R', 'T', 'T', 'R', 'K', '\0' };
+	constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+}
+
+bool TrackBinary::load(const std::string& path, std::uint64_t sourceHash, std::uint64_t buildHash) {
+	points = {};
+	file = MappedFile(path);
+	if (!file.isOpen() || file.size() < sizeof(Header)) return false;
+
+	Header header;
+	std::memcpy(&header, file.data(), sizeof(Header));
+
+	bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION
+		&& header.pointSize == sizeof(TrackPoint) && header.buildHash == buildHash
+		&& (sourceHash == 0 || header.sourceHash == sourceHash)
+		&& file.size() == sizeof(Header) + header.pointCount * sizeof(TrackPoint);
+
+	if (!valid) {
+		file = MappedFile();
+		return false;
+	}
+
+	points = { reinterpret_cast<const TrackPoint*>(file.data() + sizeof(Header)), static_cast<size_t>(header.pointCount) };
+	return true;
+}
+
+bool TrackBinary::save(const std::string& path, std::uint64_t sourceHash, std::uint64_t buildHash, std::span<const TrackPoint> points) {
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.pointSize = sizeof(TrackPoint);
+	header.sourceHash = sourceHash;
+	header.buildHash = buildHash;
+	header.pointCount = points.size();
+
+	// Written aside and renamed over the old file, so a mapping of the previous version stays valid.
+	// On Windows the rename only succeeds because MappedFile opens with FILE_SHARE_DELETE.
+	std::string temporaryPath = path + ".tmp";
+	std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	out.write(reinterpret_cast<const char*>(points.data()), points.size_bytes());
+	out.close();
+
+	std::error_code error;
+	if (out) std::filesystem::rename(temporaryPath, path, error);
+	if (!out || error) {
+		std::filesystem::remove(temporaryPath, error);
+		std::cerr << "Failed to write compiled track: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::uint64_t TrackBinary::hash(const void* data, size_t size, std::uint64_t seed) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; ++i)
+		seed = (seed ^ bytes[i]) * FNV_PRIME;
+	return seed;
+}
\ No newline at end of file
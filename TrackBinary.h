@@ -0,0 +1,29 @@
+#pragma once
+#include "DataClasses.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <span>
+
+class TrackBinary {
+	struct Header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t pointSize;
+		std::uint64_t sourceHash;
+		std::uint64_t buildHash;
+		std::uint64_t pointCount;
+	};
+
+	MappedFile file;
+
+public:
+	static constexpr std::uint32_t VERSION = 2;
+
+	std::span<const TrackPoint> points;
+
+	// A sourceHash of 0 skips the source check, for when there is no source to compare against.
+	bool load(const std::string& path, std::uint64_t sourceHash, std::uint64_t buildHash);
+	static bool save(const std::string& path, std::uint64_t sourceHash, std::uint64_t buildHash, std::span<const TrackPoint> points);
+	static std::uint64_t hash(const void* data, size_t size, std::uint64_t seed = 14695981039346656037ull);
+};
\ No newline at end of file
@@ -0,0 +1,681 @@
+#include "TrackBuilder.h"
+#include "Parallel.h"
+#include <string_view>
+#include <type_traits>
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+
+namespace {
+	constexpr float CAR_LENGTH = 6.0f, WHEEL_LENGTH_OFFSET_RATIO = 0.32f;
+	constexpr float WHEEL_BASE = CAR_LENGTH * WHEEL_LENGTH_OFFSET_RATIO * 2;
+
+	constexpr float SIZE = 8.0f;
+	constexpr float ELLIPSE_A = 6.0f * SIZE, ELLIPSE_B = 3.0f * SIZE;
+
+	constexpr float TRACKS_THICKNESS = 0.36f, TRACKS_HALF_WIDTH = 1.5f;
+	constexpr float SCALE_HEIGHT = 8.0f * SIZE;
+
+	constexpr float SUPPORT_RADIUS = 0.1f, SUPPORT_SPACING = 1.5f;
+	constexpr float SUPPORT_VERTICAL_SPACING = 1.8f;
+	constexpr float SUPPORT_TOP_DEPTH_RATIO = 0.75f, SUPPORT_EDGE_INSET_RATIO = 1.1f, BRACE_RADIUS_RATIO = 0.64f;
+	constexpr float FIRST_BRACE_DROP_RATIO = 0.67f, LOWEST_BRACE_RATIO = 0.1f;
+
+	constexpr size_t RING_VERTEX_COUNT = 8, SEGMENT_INDEX_COUNT = 24;
+	constexpr float CHUNK_SIZE = 16.0f;
+	constexpr VertexFormat TRACKS_VERTEX_FORMAT = VertexFormat::PACKED;
+
+	constexpr float PITCH_SMOOTHING = 0.05f, MIN_POINT_SPACING = 1e-4f;
+	const std::string COMPILED_EXTENSION = "bin", MESH_CACHE_EXTENSION = "mesh";
+	constexpr size_t MAX_REPORTED_PARSE_ERRORS = 10;
+
+	const char* skipBlanks(const char* it, const char* end) {
+		while (it < end && (*it == ' ' || *it == '\t' || *it == '\r')) ++it;
+		return it;
+	}
+
+	const char* parseFloat(const char* it, const char* end, float& value) {
+		if (it < end && *it == '+') ++it;
+		auto [ptr, error] = std::from_chars(it, end, value);
+		return error == std::errc() ? ptr : nullptr;
+	}
+
+	// One cross-section of the rail. Each corner is split into two vertices so the top/bottom and
+	// side faces keep hard edges, while consecutive segments share the whole ring.
+	void writeRing(Vertex* ring, const glm::vec3& center, const glm::vec3& perp, const glm::vec3& surfaceNormal) {
+		glm::vec3 topLeft = center + perp * TRACKS_HALF_WIDTH, topRight = center - perp * TRACKS_HALF_WIDTH;
+		glm::vec3 bottomLeft = topLeft - surfaceNormal * TRACKS_THICKNESS, bottomRight = topRight - surfaceNormal * TRACKS_THICKNESS;
+
+		ring[0] = { topLeft, surfaceNormal };
+		ring[1] = { topRight, surfaceNormal };
+		ring[2] = { bottomLeft, -surfaceNormal };
+		ring[3] = { bottomRight, -surfaceNormal };
+		ring[4] = { topLeft, perp };
+		ring[5] = { bottomLeft, perp };
+		ring[6] = { topRight, -perp };
+		ring[7] = { bottomRight, -perp };
+	}
+
+	float segmentDistance(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b) {
+		glm::vec3 ab = b - a;
+		float lengthSq = glm::dot(ab, ab);
+		float t = lengthSq > 0.0f ? std::clamp(glm::dot(point - a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+		return glm::distance(point, a + ab * t);
+	}
+
+	// The rails follow the rotation-minimizing frames, so they roll together with the cars.
+	glm::vec3 railRight(const TrackPoint& point) {
+		return point.orientation * glm::vec3(0.0f, 0.0f, 1.0f);
+	}
+
+	glm::vec3 railUp(const TrackPoint& point) {
+		return point.orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+	}
+
+	// The centre line and the four corners of the rail cross-section, as writeRing places them.
+	struct RailSection {
+		glm::vec3 points[5];
+	};
+
+	RailSection railSection(const TrackPoint& point) {
+		glm::vec3 side = railRight(point) * TRACKS_HALF_WIDTH, depth = railUp(point) * TRACKS_THICKNESS;
+		return { { point.center, point.center + side, point.center - side, point.center + side - depth, point.center - side - depth } };
+	}
+
+	// How far the centre line or any corner of the rail strays from the chord that would replace it.
+	// The corners come from the same rolled frames the rail geometry is built from.
+	float chordDeviation(const RailSection& a, const RailSection& b, const RailSection& point) {
+		float deviation = 0.0f;
+		for (size_t i = 0; i < std::size(point.points); ++i)
+			deviation = std::max(deviation, segmentDistance(point.points[i], a.points[i], b.points[i]));
+		return deviation;
+	}
+
+	std::int64_t chunkCell(const glm::vec3& position) {
+		auto x = static_cast<std::int32_t>(std::floor(position.x / CHUNK_SIZE));
+		auto z = static_cast<std::int32_t>(std::floor(position.z / CHUNK_SIZE));
+		return (static_cast<std::int64_t>(x) << 32) | static_cast<std::uint32_t>(z);
+	}
+
+	std::uint64_t buildHash() {
+		const float constants[] = { WHEEL_BASE, ELLIPSE_A, ELLIPSE_B, TRACKS_THICKNESS, SCALE_HEIGHT, PITCH_SMOOTHING, MIN_POINT_SPACING };
+		return TrackBinary::hash(constants, sizeof(constants));
+	}
+
+	constexpr char MESH_CACHE_MAGIC[8] = { 'S', 'M', 'R', 'T', 'M', 'S', 'H', '\0' };
+	constexpr std::uint32_t MESH_CACHE_VERSION = 3;
+
+	struct MeshCacheHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t vertexFormat;
+		std::uint64_t sourceHash;
+		std::uint64_t meshHash;
+		BoundingBox vertexBounds;
+		std::uint64_t vertexBytes, vertexCount, indexCount, cylinderCount;
+		std::uint64_t trackChunkCount, supportChunkCount, renderPointCount;
+		float maxDeviation;
+		std::uint32_t tracksIndicesCount;
+	};
+
+	// Everything the generated mesh depends on: the final points it was built from and every constant applied to them.
+	std::uint64_t meshHash(float simplifyTolerance, std::span<const TrackPoint> points) {
+		const float constants[] = { TRACKS_HALF_WIDTH, SUPPORT_RADIUS, SUPPORT_SPACING, SUPPORT_VERTICAL_SPACING, CHUNK_SIZE, simplifyTolerance,
+			SUPPORT_TOP_DEPTH_RATIO, SUPPORT_EDGE_INSET_RATIO, BRACE_RADIUS_RATIO, FIRST_BRACE_DROP_RATIO, LOWEST_BRACE_RATIO,
+			float(TRACKS_VERTEX_FORMAT), float(RING_VERTEX_COUNT), float(SEGMENT_INDEX_COUNT), float(sizeof(PackedVertex)), float(sizeof(Cylinder)),
+			float(TrackBinary::VERSION), float(sizeof(TrackPoint)) };
+		std::uint64_t seed = TrackBinary::hash(constants, sizeof(constants), buildHash());
+		return TrackBinary::hash(points.data(), points.size_bytes(), seed);
+	}
+}
+
+template<typename Step>
+auto TrackBuilder::timed(const char* name, Step&& step) {
+	auto start = std::chrono::steady_clock::now();
+	auto record = [&] { stages.push_back({ name, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() }); };
+	if constexpr (std::is_void_v<decltype(step())>) {
+		step();
+		record();
+	} else {
+		auto result = step();
+		record();
+		return result;
+	}
+}
+
+TrackBuilder::TrackBuilder(const std::string& filePath, float simplifyTolerance, bool useCaches) : simplifyTolerance(simplifyTolerance) {
+	loadTrack(filePath, useCaches, useCaches);
+	stats.pointCount = points.size();
+	if (useCaches && points.size() >= 2 && timed("load mesh cache", [&] { return loadMeshCache(meshPath(filePath)); }))
+		return;
+
+	timed("simplify", [&] { simplifyPoints(); });
+	timed("segments", [&] { buildSegmentGeometry(); });
+	timed("support", [&] { buildSupport(); });
+	timed("chunks", [&] { buildChunks(); });
+	timed("encode", [&] { encodedVertices = EncodedVertices(vertices, TRACKS_VERTEX_FORMAT); });
+
+	stats.renderPointCount = renderPoints.size();
+	stats.cylinderCount = cylinders.size();
+	stats.vertexCount = vertices.size();
+	stats.vertexBytes = encodedVertices.data().size();
+	stats.indexCount = indices.size();
+	stats.chunkCount = trackChunks.size() + supportChunks.size();
+
+	if (useCaches && sourceHash != 0)
+		timed("save mesh cache", [&] { saveMesh(meshPath(filePath)); });
+}
+
+// The points alone, for what only rides the track: taken from an up to date compiled track when there
+// is one and parsed otherwise, without generating the mesh or writing anything next to the track.
+TrackBuilder TrackBuilder::pointsOnly(const std::string& filePath) {
+	TrackBuilder builder;
+	builder.loadTrack(filePath, true, false);
+	builder.stats.pointCount = builder.points.size();
+	return builder;
+}
+
+std::span<const TrackPoint> TrackBuilder::getPoints() const {
+	return points;
+}
+
+const EncodedVertices& TrackBuilder::getVertices() const {
+	return encodedVertices;
+}
+
+const std::vector<unsigned int>& TrackBuilder::getIndices() const {
+	return indices;
+}
+
+const std::vector<Cylinder>& TrackBuilder::getCylinders() const {
+	return cylinders;
+}
+
+const std::vector<TrackBuilder::Chunk>& TrackBuilder::getTrackChunks() const {
+	return trackChunks;
+}
+
+const std::vector<TrackBuilder::Chunk>& TrackBuilder::getSupportChunks() const {
+	return supportChunks;
+}
+
+const TrackBuilder::Stats& TrackBuilder::getStats() const {
+	return stats;
+}
+
+const std::vector<TrackBuilder::Stage>& TrackBuilder::getStages() const {
+	return stages;
+}
+
+bool TrackBuilder::saveCompiled(const std::string& path) const {
+	return TrackBinary::save(path, sourceHash, buildHash(), points);
+}
+
+std::string TrackBuilder::compiledPath(const std::string& filePath) {
+	return filePath + COMPILED_EXTENSION;
+}
+
+std::string TrackBuilder::meshPath(const std::string& filePath) {
+	return filePath + MESH_CACHE_EXTENSION;
+}
+
+bool TrackBuilder::loadMeshCache(const std::string& path) {
+	MappedFile file(path);
+	if (!file.isOpen() || file.size() < sizeof(MeshCacheHeader)) return false;
+
+	MeshCacheHeader header;
+	std::memcpy(&header, file.data(), sizeof(MeshCacheHeader));
+
+	size_t expectedSize = sizeof(MeshCacheHeader) + header.vertexBytes + header.indexCount * sizeof(unsigned int)
+		+ header.cylinderCount * sizeof(Cylinder) + (header.trackChunkCount + header.supportChunkCount) * sizeof(Chunk);
+	bool valid = std::memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) == 0 && header.version == MESH_CACHE_VERSION
+		&& header.meshHash == meshHash(simplifyTolerance, points) && (sourceHash == 0 || header.sourceHash == sourceHash)
+		&& header.vertexFormat == std::uint32_t(TRACKS_VERTEX_FORMAT) && file.size() == expectedSize;
+	if (!valid) return false;
+
+	const char* it = file.data() + sizeof(MeshCacheHeader);
+	auto read = [&it]<typename T>(std::vector<T>& out, size_t count) {
+		out.resize(count);
+		std::memcpy(out.data(), it, count * sizeof(T));
+		it += count * sizeof(T);
+		};
+
+	std::vector<std::byte> vertexBytes;
+	read(vertexBytes, header.vertexBytes);
+	read(indices, header.indexCount);
+	read(cylinders, header.cylinderCount);
+	read(trackChunks, header.trackChunkCount);
+	read(supportChunks, header.supportChunkCount);
+
+	encodedVertices = EncodedVertices(TRACKS_VERTEX_FORMAT, header.vertexBounds, std::move(vertexBytes));
+	tracksIndicesCount = header.tracksIndicesCount;
+
+	stats.renderPointCount = header.renderPointCount;
+	stats.maxDeviation = header.maxDeviation;
+	stats.cylinderCount = cylinders.size();
+	stats.vertexCount = header.vertexCount;
+	stats.vertexBytes = encodedVertices.data().size();
+	stats.indexCount = indices.size();
+	stats.chunkCount = trackChunks.size() + supportChunks.size();
+	return true;
+}
+
+bool TrackBuilder::saveMesh(const std::string& path) const {
+	MeshCacheHeader header{};
+	std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+	header.version = MESH_CACHE_VERSION;
+	header.vertexFormat = std::uint32_t(TRACKS_VERTEX_FORMAT);
+	header.sourceHash = sourceHash;
+	header.meshHash = meshHash(simplifyTolerance, points);
+	header.vertexBounds = encodedVertices.getBounds();
+	header.vertexBytes = encodedVertices.data().size();
+	header.vertexCount = vertices.size();
+	header.indexCount = indices.size();
+	header.cylinderCount = cylinders.size();
+	header.trackChunkCount = trackChunks.size();
+	header.supportChunkCount = supportChunks.size();
+	header.renderPointCount = renderPoints.size();
+	header.maxDeviation = stats.maxDeviation;
+	header.tracksIndicesCount = tracksIndicesCount;
+
+	std::string temporaryPath = path + ".tmp";
+	std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+	auto write = [&out](const auto& data) {
+		out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(data[0]));
+		};
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+	write(encodedVertices.data());
+	write(indices);
+	write(cylinders);
+	write(trackChunks);
+	write(supportChunks);
+	out.close();
+
+	std::error_code error;
+	if (out) std::filesystem::rename(temporaryPath, path, error);
+	if (!out || error) {
+		std::filesystem::remove(temporaryPath, error);
+		std::cerr << "Failed to write track mesh: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void TrackBuilder::buildChunks() {
+	std::vector<std::pair<std::int64_t, size_t>> segments;
+	for (size_t i = 0; i < indices.size() / SEGMENT_INDEX_COUNT; ++i)
+		segments.emplace_back(chunkCell(vertices[indices[i * SEGMENT_INDEX_COUNT]].position), i);
+	std::sort(segments.begin(), segments.end());
+
+	std::vector<unsigned int> chunkedIndices;
+	chunkedIndices.reserve(indices.size());
+	for (size_t i = 0; i < segments.size(); ++i) {
+		if (i == 0 || segments[i].first != segments[i - 1].first)
+			trackChunks.push_back({ {}, (unsigned int)chunkedIndices.size(), 0 });
+
+		Chunk& chunk = trackChunks.back();
+		auto segmentIndices = indices.begin() + segments[i].second * SEGMENT_INDEX_COUNT;
+		chunkedIndices.insert(chunkedIndices.end(), segmentIndices, segmentIndices + SEGMENT_INDEX_COUNT);
+		for (auto index = segmentIndices; index != segmentIndices + SEGMENT_INDEX_COUNT; ++index)
+			chunk.bounds.grow(vertices[*index].position);
+		chunk.count += SEGMENT_INDEX_COUNT;
+	}
+	indices = std::move(chunkedIndices);
+
+	std::stable_sort(cylinders.begin(), cylinders.end(), [](const Cylinder& a, const Cylinder& b) {
+		return chunkCell((a.bottom + a.top) * 0.5f) < chunkCell((b.bottom + b.top) * 0.5f);
+		});
+
+	for (size_t i = 0; i < cylinders.size(); ++i) {
+		const Cylinder& cylinder = cylinders[i];
+		if (i == 0 || chunkCell((cylinder.bottom + cylinder.top) * 0.5f) != chunkCell((cylinders[i - 1].bottom + cylinders[i - 1].top) * 0.5f))
+			supportChunks.push_back({ {}, (unsigned int)i, 0 });
+
+		Chunk& chunk = supportChunks.back();
+		chunk.bounds.grow(glm::min(cylinder.bottom, cylinder.top) - glm::vec3(cylinder.radius));
+		chunk.bounds.grow(glm::max(cylinder.bottom, cylinder.top) + glm::vec3(cylinder.radius));
+		chunk.count++;
+	}
+}
+
+void TrackBuilder::loadTrack(const std::string& filePath, bool readCache, bool writeCache) {
+	// A compiled track only stands in for a missing source; an empty or unreadable one has no points.
+	MappedFile source(filePath);
+	std::error_code error;
+	bool sourceMissing = !source.isOpen() && !std::filesystem::exists(filePath, error);
+	sourceHash = source.isOpen() ? timed("hash", [&] { return TrackBinary::hash(source.data(), source.size()); }) : 0;
+	if (readCache && (source.isOpen() || sourceMissing) && timed("load compiled", [&] { return compiled.load(compiledPath(filePath), sourceHash, buildHash()); })) {
+		points = compiled.points;
+		return;
+	}
+
+	auto points2d = timed("parse", [&] { return LoadPoints(source, filePath); });
+	if (points2d.size() < 2)
+		return;
+
+	timed("centers", [&] { computeCenters(points2d, findEllipseExtremes(points2d)); });
+	timed("merge", [&] { mergeCoincidentPoints(); });
+	if (builtPoints.size() < 2)
+		return;
+	timed("perpendiculars", [&] { computePerpendiculars(); });
+	timed("frames", [&] { computeFrames(); });
+	points = builtPoints;
+
+	if (writeCache && source.isOpen())
+		timed("save compiled", [&] { saveCompiled(compiledPath(filePath)); });
+}
+
+std::vector<std::pair<float, float>> TrackBuilder::LoadPoints(const MappedFile& source, const std::string& filePath) {
+	std::vector<std::pair<float, float>> points;
+
+	if (!source.isOpen()) {
+		std::cerr << "Failed to open track file: " << filePath << std::endl;
+		return points;
+	}
+
+	const char* it = source.data(), * end = source.data() + source.size();
+	points.reserve(std::count(it, end, '\n') + 1);
+
+	size_t lineNumber = 0, errorCount = 0;
+	while (it < end) {
+		const char* lineEnd = std::find(it, end, '\n');
+		++lineNumber;
+
+		float x, y;
+		it = skipBlanks(it, lineEnd);
+		if (it == lineEnd) {
+			it = lineEnd + 1;
+			continue;
+		}
+
+		const char* cursor = parseFloat(it, lineEnd, x);
+		if (cursor) cursor = parseFloat(skipBlanks(cursor, lineEnd), lineEnd, y);
+
+		if (cursor)
+			points.emplace_back(x, y);
+		else if (++errorCount <= MAX_REPORTED_PARSE_ERRORS)
+			std::cerr << filePath << ":" << lineNumber << ": expected two numbers, got \"" << std::string_view(it, lineEnd - it) << "\"" << std::endl;
+
+		it = lineEnd + 1;
+	}
+
+	if (errorCount > MAX_REPORTED_PARSE_ERRORS)
+		std::cerr << filePath << ": skipped " << errorCount << " malformed lines" << std::endl;
+
+	return points;
+}
+
+TrackBuilder::ElipseExtremes TrackBuilder::findEllipseExtremes(const std::vector<std::pair<float, float>>& points2d) {
+	TrackBuilder::ElipseExtremes extremes;
+	for (size_t i = 1; i < points2d.size(); ++i) {
+		if (points2d[i].first < points2d[extremes.leftEndIdx].first) extremes.leftEndIdx = i;
+		if (points2d[i].first > points2d[extremes.rightEndIdx].first) extremes.rightEndIdx = i;
+		if (points2d[i].second < extremes.minY || extremes.minY < 0) extremes.minY = points2d[i].second;
+	}
+	return extremes;
+}
+
+void TrackBuilder::computeCenters(const std::vector<std::pair<float, float>>& points2d, TrackBuilder::ElipseExtremes extremes) {
+	size_t n = points2d.size();
+	builtPoints.resize(n);
+
+	for (size_t i = 0; i < n; ++i) {
+		float y = (points2d[i].second - extremes.minY) * SCALE_HEIGHT + TRACKS_THICKNESS;
+		float dx = points2d[extremes.rightEndIdx].first - points2d[extremes.leftEndIdx].first;
+		float x = (points2d[i].first - points2d[extremes.leftEndIdx].first) / dx * 2.0f * ELLIPSE_A - ELLIPSE_A;
+		float z = ELLIPSE_B * sqrt(std::max(0.0f, 1.0f - (x * x) / (ELLIPSE_A * ELLIPSE_A)));
+		if (i > extremes.leftEndIdx && i < extremes.rightEndIdx) z = -z;
+		builtPoints[i].center = glm::vec3(x, y, z);
+	}
+}
+
+// Samples that land on the previous one, like a closing point repeating the first, give a step with no
+// direction: the perpendicular, the pitch chord and the frame transport would all be built from rounding noise.
+void TrackBuilder::mergeCoincidentPoints() {
+	auto& points = builtPoints;
+	auto coincident = [](const TrackPoint& a, const TrackPoint& b) { return glm::distance(a.center, b.center) < MIN_POINT_SPACING; };
+	points.erase(std::unique(points.begin(), points.end(), coincident), points.end());
+	while (points.size() > 1 && coincident(points.back(), points.front()))
+		points.pop_back();
+}
+
+void TrackBuilder::computePerpendiculars() {
+	auto& points = builtPoints;
+	const size_t n = points.size();
+	if (n < 2) return;
+
+	float totalDist = 0.0f;
+	glm::vec3 lastPerp(0.0f, 0.0f, 1.0f);
+	for (size_t i = 0; i < n; ++i) {
+		points[i].distance = totalDist;
+		totalDist += glm::length(points[(i + 1) % n].center - points[i].center);
+
+		glm::vec3 dir = points[(i + 1) % n].center - points[i].center;
+		dir.y = 0.0f;
+		if (glm::length(dir) > 0.0001f) {
+			dir = glm::normalize(dir);
+			lastPerp = glm::vec3(-dir.z, 0.0f, dir.x);
+		}
+		points[i].perp = lastPerp;
+	}
+
+	// Both wheel distances grow monotonically with i and wrap around at most once,
+	// so each index only restarts from zero once and the whole pass stays linear.
+	auto advance = [&](size_t& idx, float dist) {
+		if (points[idx].distance > dist) idx = 0;
+		while (idx + 1 < n && points[idx + 1].distance <= dist) ++idx;
+		};
+
+	size_t frontIdx = 0, backIdx = 0;
+	for (size_t i = 0; i < n; ++i) {
+		float frontDist = points[i].distance + WHEEL_BASE * 0.5f;
+		float backDist = points[i].distance - WHEEL_BASE * 0.5f;
+		if (frontDist >= totalDist) frontDist -= totalDist;
+		if (backDist < 0) backDist += totalDist;
+
+		advance(frontIdx, frontDist);
+		advance(backIdx, backDist);
+
+		glm::vec3 d = points[frontIdx].center - points[backIdx].center;
+		points[i].pitch = std::atan2(d.y, glm::length(glm::vec2(d.x, d.z)));
+	}
+
+	float prev = points[n - 1].pitch;
+	for (size_t i = 0; i < n; ++i) {
+		points[i].pitch = glm::mix(prev, points[i].pitch, PITCH_SMOOTHING);
+		prev = points[i].pitch;
+	}
+
+	for (size_t i = 1; i < n; ++i)
+		points[i].distance = points[i - 1].distance + glm::distance(points[i].center, points[(i + 1) % n].center);
+}
+
+// Rotation-minimizing frames by double reflection (Wang et al. 2008), transported along the smoothed
+// pitch tangents. The twist left over when the loop closes is spread evenly over its length.
+void TrackBuilder::computeFrames() {
+	auto& points = builtPoints;
+	const size_t n = points.size();
+	if (n < 2) return;
+
+	std::vector<glm::vec3> tangents(n), rights(n);
+	for (size_t i = 0; i < n; ++i) {
+		float pitch = points[i].pitch;
+		const glm::vec3& perp = points[i].perp;
+		tangents[i] = glm::normalize(glm::vec3(perp.z * std::cos(pitch), std::sin(pitch), -perp.x * std::cos(pitch)));
+	}
+
+	auto transport = [&](size_t from, size_t to) {
+		glm::vec3 step = points[to].center - points[from].center;
+		glm::vec3 right = rights[from], tangent = tangents[from];
+		float c1 = glm::dot(step, step);
+		// Without a step there is nothing to reflect across, and reflecting across the leftover tangent
+		// difference would only rotate the frame by noise, so it is just re-projected onto the new tangent.
+		if (c1 > 1e-10f) {
+			right -= (2.0f / c1) * glm::dot(step, right) * step;
+			tangent -= (2.0f / c1) * glm::dot(step, tangent) * step;
+			glm::vec3 v2 = tangents[to] - tangent;
+			float c2 = glm::dot(v2, v2);
+			if (c2 > 1e-10f) right -= (2.0f / c2) * glm::dot(v2, right) * v2;
+		}
+		return glm::normalize(right - tangents[to] * glm::dot(right, tangents[to]));
+		};
+
+	rights[0] = glm::normalize(points[0].perp - tangents[0] * glm::dot(points[0].perp, tangents[0]));
+	for (size_t i = 1; i < n; ++i)
+		rights[i] = transport(i - 1, i);
+
+	glm::vec3 closing = transport(n - 1, 0);
+	float twist = std::atan2(glm::dot(glm::cross(closing, rights[0]), tangents[0]), glm::dot(closing, rights[0]));
+	float length = points[n - 1].distance + glm::distance(points[n - 1].center, points[0].center);
+
+	for (size_t i = 0; i < n; ++i) {
+		rights[i] = glm::angleAxis(twist * points[i].distance / length, tangents[i]) * rights[i];
+		glm::vec3 up = glm::cross(rights[i], tangents[i]);
+		points[i].orientation = glm::normalize(glm::quat_cast(glm::mat3(tangents[i], up, rights[i])));
+	}
+
+	stats.frameTwist = glm::degrees(twist);
+	stats.maxFrameTurn = 0.0f;
+	for (size_t i = 0; i < n; ++i)
+		stats.maxFrameTurn = std::max(stats.maxFrameTurn, glm::degrees(std::acos(std::clamp(glm::dot(rights[i], rights[(i + 1) % n]), -1.0f, 1.0f))));
+}
+
+void TrackBuilder::simplifyPoints() {
+	size_t n = points.size();
+	renderPoints.clear();
+	if (n < 2 || simplifyTolerance <= 0.0f) {
+		renderPoints.assign(points.begin(), points.end());
+		return;
+	}
+
+	// Every sample is measured against several chords, so its rail corners are placed only once.
+	std::vector<RailSection> sections(n);
+	parallelFor(n, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			sections[i] = railSection(points[i]);
+		});
+
+	std::vector<char> keep(n, false);
+	keep.front() = keep.back() = true;
+	std::vector<std::pair<size_t, size_t>> spans = { { 0, n - 1 } };
+
+	while (!spans.empty()) {
+		auto [first, last] = spans.back();
+		spans.pop_back();
+
+		float maxDeviation = 0.0f;
+		size_t farthest = first;
+		for (size_t i = first + 1; i < last; ++i) {
+			float deviation = chordDeviation(sections[first], sections[last], sections[i]);
+			if (deviation > maxDeviation) {
+				maxDeviation = deviation;
+				farthest = i;
+			}
+		}
+
+		if (maxDeviation > simplifyTolerance) {
+			keep[farthest] = true;
+			spans.emplace_back(first, farthest);
+			spans.emplace_back(farthest, last);
+		} else {
+			stats.maxDeviation = std::max(stats.maxDeviation, maxDeviation);
+		}
+	}
+
+	for (size_t i = 0; i < n; ++i)
+		if (keep[i]) renderPoints.push_back(points[i]);
+}
+
+void TrackBuilder::buildSegmentGeometry() {
+	const auto& points = renderPoints;
+	size_t n = points.size();
+	if (n < 2) return;
+
+	size_t vertexStart = vertices.size(), indexStart = indices.size();
+	vertices.resize(vertexStart + n * RING_VERTEX_COUNT);
+	indices.resize(indexStart + n * SEGMENT_INDEX_COUNT);
+
+	parallelFor(n, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			writeRing(&vertices[vertexStart + i * RING_VERTEX_COUNT], points[i].center, railRight(points[i]), railUp(points[i]));
+		});
+
+	parallelFor(n, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			unsigned int a = (unsigned int)(vertexStart + i * RING_VERTEX_COUNT);
+			unsigned int b = (unsigned int)(vertexStart + (i + 1) % n * RING_VERTEX_COUNT);
+			unsigned int segment[] = {
+				a, b, a + 1, b, b + 1, a + 1,
+				b + 2, a + 2, b + 3, a + 2, a + 3, b + 3,
+				a + 4, a + 5, b + 4, a + 5, b + 5, b + 4,
+				b + 6, b + 7, a + 6, b + 7, a + 7, a + 6
+			};
+			std::copy(std::begin(segment), std::end(segment), indices.begin() + indexStart + i * SEGMENT_INDEX_COUNT);
+		}
+		});
+
+	tracksIndicesCount = indices.size();
+}
+
+void TrackBuilder::buildSupport() {
+	if (points.size() < 2) return;
+	std::vector<std::pair<glm::vec3, glm::vec3>> braces;
+
+	float length = SUPPORT_SPACING, minY = -1.0f;
+	for (size_t i = 0; i < points.size(); ++i) {
+		glm::vec3 start = points[i].center, end = points[(i + 1) % points.size()].center;
+		length += glm::distance(glm::vec2(start.x, start.z), glm::vec2(end.x, end.z));
+
+		if (minY < 0 || start.y < minY)
+			minY = start.y;
+
+		if (length > SUPPORT_SPACING || i == points.size() - 1) {
+			const glm::quat& frame = points[i].orientation;
+			start -= frame * glm::vec3(0.0f, TRACKS_THICKNESS * SUPPORT_TOP_DEPTH_RATIO, 0.0f);
+			addSupportColumn(start, frame * glm::vec3(0.0f, 0.0f, 1.0f), braces, minY);
+			length = 0.0f;
+			minY = -1.0f;
+		}
+	}
+}
+
+void TrackBuilder::addSupportColumn(const glm::vec3& topCenter, const glm::vec3& perp, std::vector<std::pair<glm::vec3, glm::vec3>>& previousBraces, float minY) {
+	glm::vec3 rightTop = topCenter - perp * (TRACKS_HALF_WIDTH - SUPPORT_RADIUS * SUPPORT_EDGE_INSET_RATIO);
+	glm::vec3 leftTop = topCenter + perp * (TRACKS_HALF_WIDTH - SUPPORT_RADIUS * SUPPORT_EDGE_INSET_RATIO);
+	glm::vec3 rightBottom = glm::vec3(rightTop.x, 0.0f, rightTop.z);
+	glm::vec3 leftBottom = glm::vec3(leftTop.x, 0.0f, leftTop.z);
+	addCylinder(rightBottom, rightTop, SUPPORT_RADIUS);
+	addCylinder(leftBottom, leftTop, SUPPORT_RADIUS);
+
+	float braceHeight = std::max(leftTop.y - SUPPORT_VERTICAL_SPACING * FIRST_BRACE_DROP_RATIO, leftTop.y / 2);
+	std::vector<std::pair<glm::vec3, glm::vec3>> braces;
+
+	while (braceHeight >= SUPPORT_VERTICAL_SPACING * LOWEST_BRACE_RATIO) {
+		glm::vec3 rightBrace = glm::vec3(rightTop.x, braceHeight, rightTop.z);
+		glm::vec3 leftBrace = glm::vec3(leftTop.x, braceHeight, leftTop.z);
+		addCylinder(leftBrace, rightBrace, SUPPORT_RADIUS * BRACE_RADIUS_RATIO);
+		braces.push_back(std::pair(leftBrace, rightBrace));
+
+		for (auto& braces : previousBraces) {
+			if (braces.first.y < minY && braces.first.y < braceHeight + SUPPORT_VERTICAL_SPACING && braces.first.y >= braceHeight - SUPPORT_VERTICAL_SPACING) {
+				addCylinder(braces.first, leftBrace, SUPPORT_RADIUS * BRACE_RADIUS_RATIO);
+				addCylinder(braces.second, rightBrace, SUPPORT_RADIUS * BRACE_RADIUS_RATIO);
+			}
+		}
+
+		braceHeight -= SUPPORT_VERTICAL_SPACING;
+	}
+
+	previousBraces = braces;
+}
+
+void TrackBuilder::addCylinder(const glm::vec3& bottom, const glm::vec3& top, float radius) {
+	if (glm::length(top - bottom) >= 0.001f)
+		cylinders.push_back({ bottom, top, radius });
+}
\ No newline at end of file
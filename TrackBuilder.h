@@ -0,0 +1,91 @@
+#pragma once
+#include "DataClasses.h"
+#include "TrackBinary.h"
+#include "VertexFormat.h"
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <span>
+
+// The CPU half of Tracks: parses the .track file and generates the rail and support meshes.
+// It touches no GL state, so it runs on a loader thread and in the headless track compiler.
+class TrackBuilder {
+public:
+	struct Stats {
+		size_t pointCount = 0, renderPointCount = 0, cylinderCount = 0;
+		size_t vertexCount = 0, indexCount = 0, chunkCount = 0;
+		size_t vertexBytes = 0;
+		float maxDeviation = 0.0f;
+		// In degrees, and only set when the frames were computed rather than loaded from a compiled track.
+		float frameTwist = 0.0f, maxFrameTurn = 0.0f;
+	};
+
+	struct Stage {
+		const char* name;
+		double milliseconds;
+	};
+
+	struct Chunk {
+		BoundingBox bounds;
+		unsigned int first, count;
+	};
+
+private:
+	struct ElipseExtremes {
+		size_t leftEndIdx = 0, rightEndIdx = 0;
+		float minY = -1;
+	};
+
+	std::vector<unsigned int> indices;
+	std::vector<Vertex> vertices;
+	EncodedVertices encodedVertices;
+	std::vector<TrackPoint> builtPoints;
+	std::vector<TrackPoint> renderPoints;
+	std::vector<Cylinder> cylinders;
+	std::vector<Chunk> trackChunks, supportChunks;
+	std::span<const TrackPoint> points;
+	TrackBinary compiled;
+	float simplifyTolerance = 0.0f;
+	unsigned int tracksIndicesCount = 0;
+	std::uint64_t sourceHash = 0;
+	Stats stats;
+	std::vector<Stage> stages;
+
+	template<typename Step>
+	auto timed(const char* name, Step&& step);
+
+	void loadTrack(const std::string& filePath, bool readCache, bool writeCache);
+	bool loadMeshCache(const std::string& path);
+	std::vector<std::pair<float, float>> LoadPoints(const MappedFile& source, const std::string& filePath);
+	ElipseExtremes findEllipseExtremes(const std::vector<std::pair<float, float>>& points2d);
+	void computeCenters(const std::vector<std::pair<float, float>>& points2d, TrackBuilder::ElipseExtremes extremes);
+	void mergeCoincidentPoints();
+	void computePerpendiculars();
+	void computeFrames();
+	void simplifyPoints();
+	void buildSegmentGeometry();
+	void buildSupport();
+	void addSupportColumn(const glm::vec3& topCenter, const glm::vec3& perp, std::vector<std::pair<glm::vec3, glm::vec3>>& previousBraces, float minY);
+	void addCylinder(const glm::vec3& bottom, const glm::vec3& top, float radius);
+	void buildChunks();
+
+public:
+	TrackBuilder() = default;
+	TrackBuilder(const std::string& filePath, float simplifyTolerance, bool useCaches = true);
+
+	std::span<const TrackPoint> getPoints() const;
+	const EncodedVertices& getVertices() const;
+	const std::vector<unsigned int>& getIndices() const;
+	const std::vector<Cylinder>& getCylinders() const;
+	const std::vector<Chunk>& getTrackChunks() const;
+	const std::vector<Chunk>& getSupportChunks() const;
+	const Stats& getStats() const;
+	const std::vector<Stage>& getStages() const;
+
+	bool saveCompiled(const std::string& path) const;
+	bool saveMesh(const std::string& path) const;
+
+	static TrackBuilder pointsOnly(const std::string& filePath);
+	static std::string compiledPath(const std::string& filePath);
+	static std::string meshPath(const std::string& filePath);
+};
\ No newline at end of file
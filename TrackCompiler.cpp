@@ -0,0 +1,165 @@
+#include "TrackBuilder.h"
+#include <system_error>
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <numbers>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+
+namespace {
+	constexpr float DEFAULT_SIMPLIFY_TOLERANCE = 0.005f;
+	constexpr float MAX_FRAME_TURN = 15.0f, TWIST_TOLERANCE = 1.0f;
+	constexpr int NAME_WIDTH = 18, VALUE_WIDTH = 12;
+	constexpr int SYNTHETIC_HILLS = 6;
+	constexpr double SYNTHETIC_CENTER = 0.5, SYNTHETIC_RADIUS = 0.3, SYNTHETIC_BASE = 0.04, SYNTHETIC_HILL_HEIGHT = 0.12;
+
+	int usage() {
+		std::cerr << "usage: smrtovlak-trackc <file.track> [--compiled <path>] [--mesh <path>] [--tolerance <value>] [--repeat <count>] [--twist <degrees>]\n"
+			<< "       smrtovlak-trackc --synthetic <points> [--tolerance <value>] [--repeat <count>]" << std::endl;
+		return 2;
+	}
+
+	template<typename T>
+	bool parseNumber(const char* text, T& value) {
+		const char* end = text + std::strlen(text);
+		auto [ptr, error] = std::from_chars(text, end, value);
+		return error == std::errc() && ptr == end;
+	}
+
+	template<typename Step>
+	double measure(Step&& step) {
+		auto start = std::chrono::steady_clock::now();
+		step();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// A loop with a few hills sampled at pointCount evenly spaced points, the same for the same count,
+	// so build times at different sizes compare between machines and commits.
+	bool writeSyntheticTrack(const std::string& path, int pointCount) {
+		std::ofstream out(path, std::ios::trunc);
+		out << std::setprecision(9);
+		for (int i = 0; i < pointCount; ++i) {
+			double t = double(i) / pointCount;
+			double x = SYNTHETIC_CENTER - SYNTHETIC_RADIUS * std::cos(2.0 * std::numbers::pi * t);
+			double y = SYNTHETIC_BASE + SYNTHETIC_HILL_HEIGHT * std::pow(std::sin(SYNTHETIC_HILLS * std::numbers::pi * t), 2);
+			out << x << " " << y << "\n";
+		}
+		return bool(out);
+	}
+
+	void printRow(const std::string& name, const auto& value) {
+		std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << std::setw(VALUE_WIDTH) << value << "\n";
+	}
+}
+
+// Runs the track pipeline without a window or GL context and writes the same .trackbin and
+// .trackmesh files the game would, so tracks can be precompiled on a headless build machine.
+int main(int argc, char** argv) {
+	std::string trackPath, compiledPath, meshPath;
+	float simplifyTolerance = DEFAULT_SIMPLIFY_TOLERANCE, expectedTwist = NAN;
+	int repeat = 1, syntheticPoints = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		bool valid = true;
+		if (arg == "--compiled" && hasValue) compiledPath = argv[++i];
+		else if (arg == "--mesh" && hasValue) meshPath = argv[++i];
+		else if (arg == "--tolerance" && hasValue) valid = parseNumber(argv[++i], simplifyTolerance);
+		else if (arg == "--twist" && hasValue) valid = parseNumber(argv[++i], expectedTwist);
+		else if (arg == "--repeat" && hasValue) valid = parseNumber(argv[++i], repeat) && repeat > 0;
+		else if (arg == "--synthetic" && hasValue) valid = parseNumber(argv[++i], syntheticPoints) && syntheticPoints >= 2;
+		else if (trackPath.empty() && !arg.starts_with("-")) trackPath = arg;
+		else valid = false;
+		if (!valid) return usage();
+	}
+	if (syntheticPoints > 0) {
+		if (!trackPath.empty()) return usage();
+		std::error_code error;
+		auto directory = std::filesystem::temp_directory_path(error);
+		trackPath = (directory / ("smrtovlak-synthetic-" + std::to_string(syntheticPoints) + ".track")).string();
+		if (error || !writeSyntheticTrack(trackPath, syntheticPoints)) {
+			std::cerr << "Failed to write synthetic track: " << trackPath << std::endl;
+			return 1;
+		}
+	}
+	if (trackPath.empty()) return usage();
+	if (compiledPath.empty()) compiledPath = TrackBuilder::compiledPath(trackPath);
+	if (meshPath.empty()) meshPath = TrackBuilder::meshPath(trackPath);
+
+	// Caches are neither read nor written here, so every run times the full pipeline.
+	TrackBuilder builder;
+	std::vector<TrackBuilder::Stage> stages;
+	for (int run = 0; run < repeat; ++run) {
+		builder = TrackBuilder(trackPath, simplifyTolerance, false);
+		if (run == 0) {
+			stages = builder.getStages();
+			continue;
+		}
+		for (size_t i = 0; i < std::min(stages.size(), builder.getStages().size()); ++i)
+			stages[i].milliseconds += builder.getStages()[i].milliseconds;
+	}
+
+	if (builder.getPoints().size() < 2) {
+		std::cerr << "No track points in " << trackPath << std::endl;
+		return 1;
+	}
+
+	bool written = true;
+	double compiledTime = measure([&] { written &= builder.saveCompiled(compiledPath); });
+	double meshTime = measure([&] { written &= builder.saveMesh(meshPath); });
+
+	std::error_code error;
+	auto sourceBytes = std::filesystem::file_size(trackPath, error);
+	const TrackBuilder::Stats& stats = builder.getStats();
+
+	printRow("track", trackPath);
+	printRow("source bytes", error ? 0 : sourceBytes);
+	printRow("points", stats.pointCount);
+	printRow("render points", stats.renderPointCount);
+	printRow("vertices", stats.vertexCount);
+	printRow("vertex bytes", stats.vertexBytes);
+	printRow("indices", stats.indexCount);
+	printRow("cylinders", stats.cylinderCount);
+	printRow("chunks", stats.chunkCount);
+	printRow("max deviation", stats.maxDeviation);
+	printRow("frame twist", stats.frameTwist);
+	printRow("max frame turn", stats.maxFrameTurn);
+
+	double total = 0.0, parse = 0.0;
+	std::cout << "\n" << std::fixed << std::setprecision(3);
+	printRow(repeat > 1 ? "stage (mean ms)" : "stage (ms)", "");
+	for (auto& stage : stages) {
+		stage.milliseconds /= repeat;
+		total += stage.milliseconds;
+		if (std::strcmp(stage.name, "parse") == 0)
+			parse = stage.milliseconds;
+		printRow(stage.name, stage.milliseconds);
+	}
+	printRow("total", total);
+	if (!error && total > 0.0)
+		printRow("MB/s", sourceBytes / (total * 1000.0));
+	if (!error && parse > 0.0)
+		printRow("parse MB/s", sourceBytes / (parse * 1000.0));
+	printRow("write compiled", compiledTime);
+	printRow("write mesh", meshTime);
+
+	// The frames are transported sample by sample, so a bad step shows up as a jump between neighbours,
+	// and a wrong transport anywhere on the loop as a different twist left to spread when it closes.
+	bool framesAgree = stats.maxFrameTurn <= MAX_FRAME_TURN;
+	if (!framesAgree)
+		std::cerr << "Adjacent track frames turn by up to " << stats.maxFrameTurn << " degrees" << std::endl;
+	if (!std::isnan(expectedTwist) && std::abs(stats.frameTwist - expectedTwist) > TWIST_TOLERANCE) {
+		std::cerr << "Frame twist is " << stats.frameTwist << " degrees, expected " << expectedTwist << std::endl;
+		framesAgree = false;
+	}
+
+	return written && framesAgree ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "TrackIndex.h"
+#include "SimdLanes.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	const TrackPose EMPTY_POSE{ { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) }, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 0.0f };
+}
+
+TrackIndex::TrackIndex(std::span<const TrackPoint> points) : points(points) {
+}
+
+void TrackIndex::rebuild(std::span<const TrackPoint> points) {
+	this->points = points;
+	rebuild();
+}
+
+void TrackIndex::rebuild() {
+	for (auto* column : { &distance, &pitch, &cx, &cy, &cz, &qw, &qx, &qy, &qz })
+		column->resize(points.size());
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		const TrackPoint& point = points[i];
+		distance[i] = point.distance;
+		pitch[i] = point.pitch;
+		cx[i] = point.center.x;
+		cy[i] = point.center.y;
+		cz[i] = point.center.z;
+		qw[i] = point.orientation.w;
+		qx[i] = point.orientation.x;
+		qy[i] = point.orientation.y;
+		qz[i] = point.orientation.z;
+	}
+}
+
+float TrackIndex::length() const {
+	return distance.empty() ? 0.0f : distance.back();
+}
+
+float TrackIndex::pitchAt(float d) const {
+	if (distance.empty()) return 0.0f;
+
+	auto it = std::upper_bound(distance.begin(), distance.end(), d);
+	size_t i = it == distance.begin() ? 0 : size_t(it - distance.begin()) - 1, next = std::min(i + 1, distance.size() - 1);
+	float span = distance[next] - distance[i];
+	float t = span > 0.0f ? std::clamp((d - distance[i]) / span, 0.0f, 1.0f) : 0.0f;
+	return glm::mix(pitch[i], pitch[next], t);
+}
+
+TrackPose TrackIndex::poseAt(float d) const {
+	TrackPose pose = EMPTY_POSE;
+	if (!distance.empty()) poseLanes<ScalarLanes>(&d, &pose);
+	return pose;
+}
+
+void TrackIndex::poseAt(std::span<const float> distances, std::span<TrackPose> poses) const {
+	size_t count = std::min(distances.size(), poses.size()), i = 0;
+	if (distance.empty()) {
+		std::fill(poses.begin(), poses.begin() + count, EMPTY_POSE);
+		return;
+	}
+
+	for (; i + SimdLanes::WIDTH <= count; i += SimdLanes::WIDTH)
+		poseLanes<SimdLanes>(&distances[i], &poses[i]);
+	for (; i < count; ++i)
+		poseLanes<ScalarLanes>(&distances[i], &poses[i]);
+}
+
+// Branchless binary search: every lane takes exactly log2(n) steps, ending on the last sample
+// whose distance is <= the query (upper_bound - 1). Neighbouring frames are only a fraction of
+// a degree apart, so they are blended with a normalized lerp instead of a slerp.
+template<typename Lanes>
+void TrackIndex::poseLanes(const float* distances, TrackPose* poses) const {
+	using Float = typename Lanes::Float;
+	using Int = typename Lanes::Int;
+
+	Float d = Lanes::load(distances);
+	Int i = Lanes::splatInt(0);
+	for (size_t length = distance.size(); length > 1;) {
+		size_t half = length / 2;
+		Int probe = Lanes::addInt(i, Lanes::splatInt(int(half)));
+		i = Lanes::selectInt(Lanes::lessEqual(Lanes::gather(distance, probe), d), probe, i);
+		length -= half;
+	}
+	Int next = Lanes::minInt(Lanes::addInt(i, Lanes::splatInt(1)), Lanes::splatInt(int(distance.size() - 1)));
+
+	Float d0 = Lanes::gather(distance, i), span = Lanes::sub(Lanes::gather(distance, next), d0);
+	Float t = Lanes::select(Lanes::greater(span, Lanes::splat(0.0f)), Lanes::clamp01(Lanes::div(Lanes::sub(d, d0), span)), Lanes::splat(0.0f));
+	auto lerp = [&](const std::vector<float>& column) {
+		Float a = Lanes::gather(column, i);
+		return Lanes::add(a, Lanes::mul(Lanes::sub(Lanes::gather(column, next), a), t));
+		};
+
+	Float aw = Lanes::gather(qw, i), ax = Lanes::gather(qx, i), ay = Lanes::gather(qy, i), az = Lanes::gather(qz, i);
+	Float bw = Lanes::gather(qw, next), bx = Lanes::gather(qx, next), by = Lanes::gather(qy, next), bz = Lanes::gather(qz, next);
+	Float dot = Lanes::add(Lanes::add(Lanes::mul(aw, bw), Lanes::mul(ax, bx)), Lanes::add(Lanes::mul(ay, by), Lanes::mul(az, bz)));
+	Float tb = Lanes::select(Lanes::greater(Lanes::splat(0.0f), dot), Lanes::sub(Lanes::splat(0.0f), t), t);
+	Float ta = Lanes::sub(Lanes::splat(1.0f), t);
+
+	Float w = Lanes::add(Lanes::mul(aw, ta), Lanes::mul(bw, tb)), x = Lanes::add(Lanes::mul(ax, ta), Lanes::mul(bx, tb));
+	Float y = Lanes::add(Lanes::mul(ay, ta), Lanes::mul(by, tb)), z = Lanes::add(Lanes::mul(az, ta), Lanes::mul(bz, tb));
+	Float norm = Lanes::sqrt(Lanes::add(Lanes::add(Lanes::mul(w, w), Lanes::mul(x, x)), Lanes::add(Lanes::mul(y, y), Lanes::mul(z, z))));
+
+	float out[8][Lanes::WIDTH];
+	Lanes::store(out[0], Lanes::div(w, norm));
+	Lanes::store(out[1], Lanes::div(x, norm));
+	Lanes::store(out[2], Lanes::div(y, norm));
+	Lanes::store(out[3], Lanes::div(z, norm));
+	Lanes::store(out[4], lerp(cx));
+	Lanes::store(out[5], lerp(cy));
+	Lanes::store(out[6], lerp(cz));
+	Lanes::store(out[7], lerp(pitch));
+
+	for (size_t lane = 0; lane < Lanes::WIDTH; ++lane) {
+		TrackPose& pose = poses[lane];
+		pose.orientation = glm::quat(out[0][lane], out[1][lane], out[2][lane], out[3][lane]);
+		pose.position = glm::vec3(out[4][lane], out[5][lane], out[6][lane]);
+		pose.pitch = out[7][lane];
+		pose.forward = pose.orientation * glm::vec3(1.0f, 0.0f, 0.0f);
+		pose.up = pose.orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include "DataClasses.h"
+#include <vector>
+#include <span>
+
+// Distance lookups over the track samples. The samples are mirrored into one contiguous column
+// per field so searches only touch the distances, and batches are resolved with SIMD lanes.
+class TrackIndex {
+	std::span<const TrackPoint> points;
+
+	std::vector<float> distance, pitch;
+	std::vector<float> cx, cy, cz;
+	std::vector<float> qw, qx, qy, qz;
+
+	template<typename Lanes>
+	void poseLanes(const float* distances, TrackPose* poses) const;
+
+public:
+	TrackIndex(std::span<const TrackPoint> points);
+
+	void rebuild();
+	void rebuild(std::span<const TrackPoint> points);
+
+	float length() const;
+	float pitchAt(float distance) const;
+	TrackPose poseAt(float distance) const;
+	void poseAt(std::span<const float> distances, std::span<TrackPose> poses) const;
+};
\ No newline at end of file
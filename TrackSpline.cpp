@@ -0,0 +1,146 @@
+#include "TrackSpline.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	constexpr float CENTRIPETAL_ALPHA = 0.5f;
+	constexpr float MIN_KNOT_SPACING = 0.0001f;
+	constexpr size_t ARC_SAMPLES_PER_SEGMENT = 16;
+
+	// 3-point Gauss-Legendre on [-1, 1]; |p'| is smooth enough over a sixteenth of a segment.
+	constexpr float GAUSS_NODES[] = { -0.7745966692f, 0.0f, 0.7745966692f };
+	constexpr float GAUSS_WEIGHTS[] = { 0.5555555556f, 0.8888888889f, 0.5555555556f };
+
+	glm::vec3 derivative(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float u) {
+		return (3.0f * a * u + 2.0f * b) * u + c;
+	}
+
+	float knotSpacing(const glm::vec3& from, const glm::vec3& to) {
+		return std::max(std::pow(glm::length(to - from), CENTRIPETAL_ALPHA), MIN_KNOT_SPACING);
+	}
+}
+
+TrackSpline::TrackSpline(std::span<const TrackPoint> points, size_t controlPointCount) {
+	size_t n = points.size();
+	if (n < 4 || controlPointCount < 4) return;
+
+	// Control points are picked at even steps of the sampled distance rather than every k-th
+	// sample, so dense and sparse parts of the source file end up with similar spacing.
+	float sampledLength = points.back().distance + glm::distance(points.back().center, points.front().center);
+	std::vector<size_t> controls;
+	for (size_t j = 0, i = 0; j < std::min(controlPointCount, n); ++j) {
+		float target = sampledLength * j / controlPointCount;
+		while (i + 1 < n && points[i + 1].distance <= target) ++i;
+		if (controls.empty() || controls.back() != i) controls.push_back(i);
+	}
+	size_t m = controls.size();
+	if (m < 4) return;
+
+	segments.resize(m);
+	for (size_t s = 0; s < m; ++s) {
+		const glm::vec3& p0 = points[controls[(s + m - 1) % m]].center;
+		const glm::vec3& p1 = points[controls[s]].center;
+		const glm::vec3& p2 = points[controls[(s + 1) % m]].center;
+		const glm::vec3& p3 = points[controls[(s + 2) % m]].center;
+
+		float t01 = knotSpacing(p0, p1), t12 = knotSpacing(p1, p2), t23 = knotSpacing(p2, p3);
+		glm::vec3 m1 = ((p1 - p0) / t01 - (p2 - p0) / (t01 + t12) + (p2 - p1) / t12) * t12;
+		glm::vec3 m2 = ((p2 - p1) / t12 - (p3 - p1) / (t12 + t23) + (p3 - p2) / t23) * t12;
+
+		Segment& segment = segments[s];
+		segment.a = 2.0f * p1 - 2.0f * p2 + m1 + m2;
+		segment.b = -3.0f * p1 + 3.0f * p2 - 2.0f * m1 - m2;
+		segment.c = m1;
+		segment.d = p1;
+		segment.startRight = points[controls[s]].orientation * glm::vec3(0.0f, 0.0f, 1.0f);
+		segment.endRight = points[controls[(s + 1) % m]].orientation * glm::vec3(0.0f, 0.0f, 1.0f);
+	}
+
+	arcTable.reserve(m * ARC_SAMPLES_PER_SEGMENT + 1);
+	for (size_t s = 0; s < m; ++s) {
+		for (size_t k = 0; k < ARC_SAMPLES_PER_SEGMENT; ++k) {
+			float u = float(k) / ARC_SAMPLES_PER_SEGMENT;
+			arcTable.push_back({ totalLength, (unsigned int)s, u });
+			totalLength += arcLength(segments[s], u, u + 1.0f / ARC_SAMPLES_PER_SEGMENT);
+		}
+	}
+	arcTable.push_back({ totalLength, (unsigned int)(m - 1), 1.0f });
+}
+
+float TrackSpline::arcLength(const Segment& segment, float from, float to) {
+	float half = (to - from) * 0.5f, mid = (to + from) * 0.5f, sum = 0.0f;
+	for (int i = 0; i < 3; ++i)
+		sum += GAUSS_WEIGHTS[i] * glm::length(derivative(segment.a, segment.b, segment.c, mid + half * GAUSS_NODES[i]));
+	return sum * half;
+}
+
+const TrackSpline::Segment& TrackSpline::locate(float distance, float& u) const {
+	distance = std::clamp(distance, 0.0f, totalLength);
+	auto it = std::upper_bound(arcTable.begin(), arcTable.end(), distance,
+		[](float d, const ArcSample& sample) { return d < sample.distance; });
+	const ArcSample& sample = *(it == arcTable.begin() ? it : std::min(it, arcTable.end() - 1) - 1);
+	const Segment& segment = segments[sample.segment];
+
+	// One Newton step from the table entry: s(u) - target divided by |p'(u)|.
+	float step = 1.0f / ARC_SAMPLES_PER_SEGMENT;
+	float speed = glm::length(derivative(segment.a, segment.b, segment.c, sample.u));
+	u = sample.u + (speed > 0.0f ? (distance - sample.distance) / speed : 0.0f);
+	u = std::clamp(u, sample.u, std::min(sample.u + step, 1.0f));
+	speed = glm::length(derivative(segment.a, segment.b, segment.c, u));
+	if (speed > 0.0f)
+		u = std::clamp(u - (sample.distance + arcLength(segment, sample.u, u) - distance) / speed, sample.u, std::min(sample.u + step, 1.0f));
+	return segment;
+}
+
+bool TrackSpline::empty() const {
+	return segments.empty();
+}
+
+size_t TrackSpline::controlPointCount() const {
+	return segments.size();
+}
+
+float TrackSpline::length() const {
+	return totalLength;
+}
+
+glm::vec3 TrackSpline::positionAt(float distance) const {
+	if (segments.empty()) return glm::vec3(0.0f);
+	float u;
+	const Segment& s = locate(distance, u);
+	return ((s.a * u + s.b) * u + s.c) * u + s.d;
+}
+
+glm::vec3 TrackSpline::tangentAt(float distance) const {
+	if (segments.empty()) return glm::vec3(0.0f, 0.0f, 1.0f);
+	float u;
+	const Segment& s = locate(distance, u);
+	glm::vec3 velocity = derivative(s.a, s.b, s.c, u);
+	return glm::length(velocity) > 0.0f ? glm::normalize(velocity) : glm::normalize(s.a + s.b + s.c);
+}
+
+float TrackSpline::pitchAt(float distance) const {
+	return std::asin(std::clamp(tangentAt(distance).y, -1.0f, 1.0f));
+}
+
+TrackPose TrackSpline::poseAt(float distance) const {
+	TrackPose pose{ { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) }, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 0.0f };
+	if (segments.empty()) return pose;
+
+	float u;
+	const Segment& s = locate(distance, u);
+	glm::vec3 velocity = derivative(s.a, s.b, s.c, u);
+	if (glm::length(velocity) > 0.0f) pose.forward = glm::normalize(velocity);
+
+	// The roll comes from the rotation-minimizing frames of the samples at the control points,
+	// blended across the segment and squared up with the spline's own tangent.
+	glm::vec3 right = glm::mix(s.startRight, s.endRight, u);
+	right -= pose.forward * glm::dot(right, pose.forward);
+	right = glm::length(right) > 0.0001f ? glm::normalize(right) : s.startRight;
+
+	pose.position = ((s.a * u + s.b) * u + s.c) * u + s.d;
+	pose.pitch = std::asin(std::clamp(pose.forward.y, -1.0f, 1.0f));
+	pose.up = glm::normalize(glm::cross(right, pose.forward));
+	pose.orientation = glm::normalize(glm::quat_cast(glm::mat3(pose.forward, pose.up, right)));
+	return pose;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include "DataClasses.h"
+#include <vector>
+#include <span>
+
+// Closed centripetal Catmull-Rom spline fitted through a subset of the track samples,
+// reparameterized by arc length so lookups take the same distances as TrackIndex.
+class TrackSpline {
+	struct Segment {
+		glm::vec3 a, b, c, d;
+		glm::vec3 startRight, endRight;
+	};
+
+	struct ArcSample {
+		float distance;
+		unsigned int segment;
+		float u;
+	};
+
+	std::vector<Segment> segments;
+	std::vector<ArcSample> arcTable;
+	float totalLength = 0.0f;
+
+	static float arcLength(const Segment& segment, float from, float to);
+	const Segment& locate(float distance, float& u) const;
+
+public:
+	TrackSpline() = default;
+	TrackSpline(std::span<const TrackPoint> points, size_t controlPointCount);
+
+	bool empty() const;
+	size_t controlPointCount() const;
+
+	float length() const;
+	glm::vec3 positionAt(float distance) const;
+	glm::vec3 tangentAt(float distance) const;
+	float pitchAt(float distance) const;
+	TrackPose poseAt(float distance) const;
+};
\ No newline at end of file
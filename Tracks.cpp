@@ -4,31 +4,74 @@
 #include <algorithm>
 #include <GL/glew.h>
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <cstring>
+#include <chrono>
 #include <numbers>
 #include <cmath>
 
 namespace {
-	constexpr float CAR_LENGTH = 6.0f, WHEEL_LENGTH_OFFSET_RATIO = 0.32f;
-	constexpr float WHEEL_BASE = CAR_LENGTH * WHEEL_LENGTH_OFFSET_RATIO * 2;
-
-	constexpr float SIZE = 8.0f;
-	constexpr float ELLIPSE_A = 6.0f * SIZE, ELLIPSE_B = 3.0f * SIZE;
-
-	constexpr float TRACKS_THICKNESS = 0.36f, TRACKS_HALF_WIDTH = 1.5f;
 	constexpr glm::vec3 TRACKS_COLOR(0.8f, 0.4f, 0.1f);
-	constexpr float SCALE_HEIGHT = 8.0f * SIZE;
-
-	constexpr float SUPPORT_RADIUS = 0.1f, SUPPORT_SPACING = 1.5f;
-	constexpr float SUPPORT_VERTICAL_SPACING = 1.8f;
 	constexpr glm::vec3 SUPPORT_COLOR(0.5f, 0.5f, 0.5f);
 	constexpr int SUPPORT_NUM_SIDES = 16;
+
+	// Uploads only the span between the first and last element that differ from what the buffer
+	// already holds; a buffer that has to grow is reallocated as a whole.
+	template<typename T>
+	size_t patchBuffer(GLenum target, unsigned int buffer, const std::vector<T>& current, const std::vector<T>& next) {
+		auto same = [](const T& a, const T& b) { return std::memcmp(&a, &b, sizeof(T)) == 0; };
+		glBindBuffer(target, buffer);
+
+		GLint capacity = 0;
+		glGetBufferParameteriv(target, GL_BUFFER_SIZE, &capacity);
+		if (next.size() * sizeof(T) > size_t(capacity)) {
+			glBufferData(target, next.size() * sizeof(T), next.data(), GL_STATIC_DRAW);
+			return next.size() * sizeof(T);
+		}
+
+		size_t common = std::min(current.size(), next.size());
+		size_t first = std::mismatch(current.begin(), current.begin() + common, next.begin(), same).first - current.begin();
+		size_t last = next.size();
+		if (current.size() == next.size())
+			last -= std::mismatch(current.rbegin(), current.rend() - first, next.rbegin(), same).first - current.rbegin();
+		if (first >= last) return 0;
+
+		glBufferSubData(target, first * sizeof(T), (last - first) * sizeof(T), next.data() + first);
+		return (last - first) * sizeof(T);
+	}
+
+	// Unit cylinder along +z with (x, y) on the unit circle; the vertex shader places it between each instance's endpoints.
+	void buildUnitCylinder(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+		for (int i = 0; i <= SUPPORT_NUM_SIDES; ++i) {
+			float angle = i * 2.0f * std::numbers::pi_v<float> / SUPPORT_NUM_SIDES;
+			glm::vec3 normal(cos(angle), sin(angle), 0.0f);
+			vertices.push_back({ normal, normal });
+			vertices.push_back({ normal + glm::vec3(0.0f, 0.0f, 1.0f), normal });
+		}
+
+		for (unsigned int i = 0; i < SUPPORT_NUM_SIDES; ++i) {
+			unsigned int b0 = i * 2, b1 = b0 + 1, b2 = (i + 1) * 2, b3 = b2 + 1;
+			indices.insert(indices.end(), { b0, b2, b1, b1, b2, b3 });
+		}
+	}
+}
+
+Tracks::Tracks(const std::string& filePath, float simplifyTolerance, size_t splineControlPoints)
+	: Tracks(CpuOnly{}, filePath, simplifyTolerance, splineControlPoints) {
+	upload();
 }
 
-Tracks::Tracks(const std::string& filePath) {
-	buildMesh(filePath);
+Tracks::Tracks(CpuOnly, const std::string& filePath, float simplifyTolerance, size_t splineControlPoints)
+	: mesh(filePath, simplifyTolerance), filePath(filePath), simplifyTolerance(simplifyTolerance), splineControlPoints(splineControlPoints),
+	points(mesh.getPoints()), index(points) {
+	index.rebuild();
+	if (splineControlPoints > 0)
+		spline = TrackSpline(points, splineControlPoints);
+
+	static_cast<TrackBuilder::Stats&>(stats) = mesh.getStats();
+	stats.splineControlPointCount = spline.controlPointCount();
+}
 
+void Tracks::upload() {
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
 	glGenBuffers(1, &EBO);
@@ -36,253 +79,187 @@ Tracks::Tracks(const std::string& filePath) {
 	glBindVertexArray(VAO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+	mesh.getVertices().upload();
 
+	const auto& indices = mesh.getIndices();
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
+	std::vector<Vertex> cylinderVertices;
+	std::vector<unsigned int> cylinderIndices;
+	buildUnitCylinder(cylinderVertices, cylinderIndices);
+	cylinderIndicesCount = cylinderIndices.size();
+
+	glGenVertexArrays(1, &supportVAO);
+	glGenBuffers(1, &cylinderVBO);
+	glGenBuffers(1, &cylinderEBO);
+	glGenBuffers(1, &instanceVBO);
+
+	glBindVertexArray(supportVAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, cylinderVBO);
+	glBufferData(GL_ARRAY_BUFFER, cylinderVertices.size() * sizeof(Vertex), cylinderVertices.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cylinderEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, cylinderIndices.size() * sizeof(unsigned int), cylinderIndices.data(), GL_STATIC_DRAW);
+
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
 	glEnableVertexAttribArray(1);
 
+	const auto& cylinders = mesh.getCylinders();
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, cylinders.size() * sizeof(Cylinder), cylinders.data(), GL_STATIC_DRAW);
+
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Cylinder), (void*)offsetof(Cylinder, bottom));
+	glEnableVertexAttribArray(3);
+	glVertexAttribDivisor(3, 1);
+	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Cylinder), (void*)offsetof(Cylinder, top));
+	glEnableVertexAttribArray(4);
+	glVertexAttribDivisor(4, 1);
+	glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(Cylinder), (void*)offsetof(Cylinder, radius));
+	glEnableVertexAttribArray(5);
+	glVertexAttribDivisor(5, 1);
+
 	glBindVertexArray(0);
 }
 
-void Tracks::draw(const Shader& shader) const {
+void Tracks::draw(const Shader& shader, const glm::mat4& viewProjection) const {
+	Frustum frustum(viewProjection);
+	drawStats = {};
+
 	glm::mat4 model = glm::mat4(1.0f);
 	shader.setMat4("model", glm::value_ptr(model));
 	shader.setBool("useTexture", false);
 
 	shader.setVec3("baseColor", TRACKS_COLOR.r, TRACKS_COLOR.g, TRACKS_COLOR.b);
+	mesh.getVertices().bind(shader);
 	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, tracksIndicesCount, GL_UNSIGNED_INT, 0);
+	drawChunks(mesh.getTrackChunks(), frustum, 1, [](unsigned int first, unsigned int count) {
+		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)(first * sizeof(unsigned int)));
+		});
+	EncodedVertices::unbind(shader);
 
 	shader.setVec3("baseColor", SUPPORT_COLOR.r, SUPPORT_COLOR.g, SUPPORT_COLOR.b);
-	auto supportStart = (void*)(tracksIndicesCount * sizeof(unsigned int));
-	glDrawElements(GL_TRIANGLES, indices.size() - tracksIndicesCount, GL_UNSIGNED_INT, supportStart);
+	shader.setBool("instanced", true);
+	glBindVertexArray(supportVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	drawChunks(mesh.getSupportChunks(), frustum, cylinderIndicesCount, [&](unsigned int first, unsigned int count) {
+		size_t offset = first * sizeof(Cylinder);
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Cylinder), (void*)(offset + offsetof(Cylinder, bottom)));
+		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Cylinder), (void*)(offset + offsetof(Cylinder, top)));
+		glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(Cylinder), (void*)(offset + offsetof(Cylinder, radius)));
+		glDrawElementsInstanced(GL_TRIANGLES, cylinderIndicesCount, GL_UNSIGNED_INT, 0, count);
+		});
+	shader.setBool("instanced", false);
 
 	glBindVertexArray(0);
 }
 
-void Tracks::buildMesh(const std::string& filePath) {
-	auto points2d = LoadPoints(filePath);
-	if (points2d.size() < 2)
-		return;
-
-	auto extremes = findEllipseExtremes(points2d);
-	computeCenters(points2d, extremes);
-	computePerpendiculars();
-	buildSegmentGeometry();
-	buildSupport();
-}
-
-std::vector<std::pair<float, float>> Tracks::LoadPoints(const std::string& filePath) {
-	std::vector<std::pair<float, float>> points;
-	std::ifstream file(filePath);
+// Chunks are stored in buffer order, so runs of visible neighbours are merged into a single draw.
+template<typename Draw>
+void Tracks::drawChunks(const std::vector<TrackBuilder::Chunk>& chunks, const Frustum& frustum, unsigned int indicesPerItem, Draw&& draw) const {
+	unsigned int runFirst = 0, runCount = 0;
+	for (const auto& chunk : chunks) {
+		size_t triangles = size_t(chunk.count) * indicesPerItem / 3;
+
+		if (!frustum.intersects(chunk.bounds)) {
+			drawStats.chunksCulled++;
+			drawStats.trianglesCulled += triangles;
+			continue;
+		}
 
-	if (!file) {
-		std::cerr << "Failed to open track file: " << filePath << std::endl;
-		return points;
-	}
+		drawStats.chunksSubmitted++;
+		drawStats.trianglesSubmitted += triangles;
 
-	std::string line;
-	while (std::getline(file, line)) {
-		std::stringstream ss(line);
-		float x, y;
-		if (ss >> x >> y)
-			points.emplace_back(x, y);
+		if (runCount > 0 && runFirst + runCount == chunk.first) {
+			runCount += chunk.count;
+		} else {
+			if (runCount > 0) draw(runFirst, runCount);
+			runFirst = chunk.first;
+			runCount = chunk.count;
+		}
 	}
 
-	file.close();
-
-	return points;
+	if (runCount > 0) draw(runFirst, runCount);
 }
 
-Tracks::ElipseExtremes Tracks::findEllipseExtremes(const std::vector<std::pair<float, float>>& points2d) {
-	Tracks::ElipseExtremes extremes;
-	for (size_t i = 1; i < points2d.size(); ++i) {
-		if (points2d[i].first < points2d[extremes.leftEndIdx].first) extremes.leftEndIdx = i;
-		if (points2d[i].first > points2d[extremes.rightEndIdx].first) extremes.rightEndIdx = i;
-		if (points2d[i].second < extremes.minY || extremes.minY < 0) extremes.minY = points2d[i].second;
-	}
-	return extremes;
+const Tracks::Stats& Tracks::getStats() const {
+	return stats;
 }
 
-void Tracks::computeCenters(const std::vector<std::pair<float, float>>& points2d, Tracks::ElipseExtremes extremes) {
-	size_t n = points2d.size();
-	points.resize(n);
-
-	for (size_t i = 0; i < n; ++i) {
-		float y = (points2d[i].second - extremes.minY) * SCALE_HEIGHT + TRACKS_THICKNESS;
-		float dx = points2d[extremes.rightEndIdx].first - points2d[extremes.leftEndIdx].first;
-		float x = (points2d[i].first - points2d[extremes.leftEndIdx].first) / dx * 2.0f * ELLIPSE_A - ELLIPSE_A;
-		float z = ELLIPSE_B * sqrt(std::max(0.0f, 1.0f - (x * x) / (ELLIPSE_A * ELLIPSE_A)));
-		if (i > extremes.leftEndIdx && i < extremes.rightEndIdx) z = -z;
-		points[i].center = glm::vec3(x, y, z);
-	}
+const Tracks::DrawStats& Tracks::getDrawStats() const {
+	return drawStats;
 }
 
-void Tracks::computePerpendiculars() {
-	const size_t n = points.size();
-	if (n < 2) return;
-
-	float totalDist = 0.0f;
-	glm::vec3 lastPerp(0.0f, 0.0f, 1.0f);
-	for (size_t i = 0; i < n; ++i) {
-		points[i].distance = totalDist;
-		totalDist += glm::length(points[(i + 1) % n].center - points[i].center);
-
-		glm::vec3 dir = points[(i + 1) % n].center - points[i].center;
-		dir.y = 0.0f;
-		if (glm::length(dir) > 0.0001f) {
-			dir = glm::normalize(dir);
-			lastPerp = glm::vec3(-dir.z, 0.0f, dir.x);
-		}
-		points[i].perp = lastPerp;
+void Tracks::reload() {
+	if (pendingReload.valid()) {
+		reloadQueued = true;
+		return;
 	}
 
-	for (size_t i = 0; i < n; ++i) {
-		float frontDist = points[i].distance + WHEEL_BASE * 0.5f;
-		float backDist = points[i].distance - WHEEL_BASE * 0.5f;
-		if (frontDist >= totalDist) frontDist -= totalDist;
-		if (backDist < 0) backDist += totalDist;
+	pendingReload = std::async(std::launch::async, [filePath = filePath, simplifyTolerance = simplifyTolerance, splineControlPoints = splineControlPoints] {
+		return std::unique_ptr<Tracks>(new Tracks(CpuOnly{}, filePath, simplifyTolerance, splineControlPoints));
+		});
+}
 
-		size_t frontIdx = 0, backIdx = 0;
-		for (size_t j = 0; j < n; ++j) {
-			if (points[j].distance <= frontDist) frontIdx = j;
-			if (points[j].distance <= backDist)  backIdx = j;
-		}
+bool Tracks::applyReload() {
+	if (!pendingReload.valid() || pendingReload.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return false;
 
-		glm::vec3 d = points[frontIdx].center - points[backIdx].center;
-		points[i].pitch = std::atan2(d.y, glm::length(glm::vec2(d.x, d.z)));
+	std::unique_ptr<Tracks> next = pendingReload.get();
+	if (reloadQueued) {
+		reloadQueued = false;
+		reload();
 	}
 
-	const float alpha = 0.05f;
-	float prev = points[n - 1].pitch;
-	for (size_t i = 0; i < n; ++i) {
-		points[i].pitch = glm::mix(prev, points[i].pitch, alpha);
-		prev = points[i].pitch;
+	// A half-written file parses to nothing; keep riding the current track until the next save.
+	if (next->points.size() < 2) {
+		std::cerr << "Ignoring reload of empty track: " << filePath << std::endl;
+		return false;
 	}
-}
+	if (next->points.size() == points.size() && std::equal(points.begin(), points.end(), next->points.begin(),
+		[](const TrackPoint& a, const TrackPoint& b) { return std::memcmp(&a, &b, sizeof(TrackPoint)) == 0; }))
+		return false;
 
-void Tracks::addQuadFace(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2, glm::vec3 v3, glm::vec3 n) {
-	unsigned int b = vertices.size();
-	vertices.insert(vertices.end(), { {v0,n}, {v1,n}, {v2,n}, {v3,n} });
-	indices.insert(indices.end(), { b, b + 2, b + 1, b + 2, b + 3, b + 1 });
+	swapIn(*next);
+	return true;
 }
 
-void Tracks::buildSegmentGeometry() {
-	size_t n = points.size();
-	if (n < 2) return;
-
-	glm::vec3 prevSurfaceNormal(0.0f, 1.0f, 0.0f);
-
-	for (size_t i = 0; i < n; ++i) {
-		size_t next = (i + 1) % n;
-		glm::vec3 c0 = points[i].center, c1 = points[next].center, p0 = points[i].perp, p1 = points[next].perp;
-
-		glm::vec3 forward0 = glm::normalize(c1 - c0);
-		glm::vec3 forward1 = (i + 2 < n) ? glm::normalize(points[(i + 2) % n].center - c1) : forward0;
-
-		glm::vec3 surfaceNormal0 = glm::normalize(glm::cross(p0, forward0));
-		if (glm::dot(surfaceNormal0, prevSurfaceNormal) < 0.0f) surfaceNormal0 = -surfaceNormal0;
-		prevSurfaceNormal = surfaceNormal0;
-
-		glm::vec3 surfaceNormal1 = glm::normalize(glm::cross(p1, forward1));
-		if (glm::dot(surfaceNormal1, surfaceNormal0) < 0.0f) surfaceNormal1 = -surfaceNormal1;
-
-		glm::vec3 tl0 = c0 + p0 * TRACKS_HALF_WIDTH, tr0 = c0 - p0 * TRACKS_HALF_WIDTH;
-		glm::vec3 tl1 = c1 + p1 * TRACKS_HALF_WIDTH, tr1 = c1 - p1 * TRACKS_HALF_WIDTH;
-
-		glm::vec3 bl0 = tl0 - surfaceNormal0 * TRACKS_THICKNESS, br0 = tr0 - surfaceNormal0 * TRACKS_THICKNESS;
-		glm::vec3 bl1 = tl1 - surfaceNormal1 * TRACKS_THICKNESS, br1 = tr1 - surfaceNormal1 * TRACKS_THICKNESS;
-
-		glm::vec3 leftNorm = glm::normalize(p0 + p1);
-		glm::vec3 avgNormal = glm::normalize(surfaceNormal0 + surfaceNormal1);
+void Tracks::swapIn(Tracks& next) {
+	glBindVertexArray(VAO);
+	size_t uploaded = patchBuffer(GL_ARRAY_BUFFER, VBO, mesh.getVertices().data(), next.mesh.getVertices().data());
+	uploaded += patchBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO, mesh.getIndices(), next.mesh.getIndices());
+	glBindVertexArray(0);
+	uploaded += patchBuffer(GL_ARRAY_BUFFER, instanceVBO, mesh.getCylinders(), next.mesh.getCylinders());
 
-		addQuadFace(tl0, tr0, tl1, tr1, avgNormal);
-		addQuadFace(bl1, br1, bl0, br0, -avgNormal);
-		addQuadFace(tl0, tl1, bl0, bl1, leftNorm);
-		addQuadFace(tr1, tr0, br1, br0, -leftNorm);
-	}
+	mesh = std::move(next.mesh);
+	spline = std::move(next.spline);
+	points = mesh.getPoints();
+	index.rebuild(points);
 
-	tracksIndicesCount = indices.size();
+	stats = next.stats;
+	stats.reloadUploadBytes = uploaded;
 }
 
-void Tracks::buildSupport() {
-	if (points.size() < 2) return;
-	std::vector<std::pair<glm::vec3, glm::vec3>> braces;
-
-	float length = SUPPORT_SPACING, minY = -1.0f;
-	for (size_t i = 0; i < points.size(); ++i) {
-		glm::vec3 start = points[i].center, end = points[(i + 1) % points.size()].center;
-		length += glm::distance(glm::vec2(start.x, start.z), glm::vec2(end.x, end.z));
-		if (i > 0) points[i].distance = points[i - 1].distance + glm::distance(start, end);
-
-		if (minY < 0 || start.y < minY)
-			minY = start.y;
-
-		if (length > SUPPORT_SPACING || i == points.size() - 1) {
-			start.y -= TRACKS_THICKNESS * 0.75f;
-			addSupportColumn(start, glm::normalize(points[i].perp), braces, minY);
-			length = 0.0f;
-			minY = -1.0f;
-		}
-	}
+float Tracks::length() const {
+	return spline.empty() ? index.length() : spline.length();
 }
 
-void Tracks::addSupportColumn(const glm::vec3& topCenter, const glm::vec3& perp, std::vector<std::pair<glm::vec3, glm::vec3>>& previousBraces, float minY) {
-	glm::vec3 rightTop = topCenter - perp * (TRACKS_HALF_WIDTH - SUPPORT_RADIUS * 1.1f);
-	glm::vec3 leftTop = topCenter + perp * (TRACKS_HALF_WIDTH - SUPPORT_RADIUS * 1.1f);
-	glm::vec3 rightBottom = glm::vec3(rightTop.x, 0.0f, rightTop.z);
-	glm::vec3 leftBottom = glm::vec3(leftTop.x, 0.0f, leftTop.z);
-	addCylinder(rightBottom, rightTop, SUPPORT_RADIUS);
-	addCylinder(leftBottom, leftTop, SUPPORT_RADIUS);
-
-	float braceHeight = std::max(leftTop.y - SUPPORT_VERTICAL_SPACING * 0.67f, leftTop.y / 2);
-	std::vector<std::pair<glm::vec3, glm::vec3>> braces;
-
-	while (braceHeight >= SUPPORT_VERTICAL_SPACING * 0.1f) {
-		glm::vec3 rightBrace = glm::vec3(rightTop.x, braceHeight, rightTop.z);
-		glm::vec3 leftBrace = glm::vec3(leftTop.x, braceHeight, leftTop.z);
-		addCylinder(leftBrace, rightBrace, SUPPORT_RADIUS * 0.64f);
-		braces.push_back(std::pair(leftBrace, rightBrace));
-
-		for (auto& braces : previousBraces) {
-			if (braces.first.y < minY && braces.first.y < braceHeight + SUPPORT_VERTICAL_SPACING && braces.first.y >= braceHeight - SUPPORT_VERTICAL_SPACING) {
-				addCylinder(braces.first, leftBrace, SUPPORT_RADIUS * 0.64f);
-				addCylinder(braces.second, rightBrace, SUPPORT_RADIUS * 0.64f);
-			}
-		}
-
-		braceHeight -= SUPPORT_VERTICAL_SPACING;
-	}
-
-	previousBraces = braces;
+float Tracks::pitchAt(float distance) const {
+	return spline.empty() ? index.pitchAt(distance) : spline.pitchAt(distance);
 }
 
-void Tracks::addCylinder(const glm::vec3& bottom, const glm::vec3& top, float radius) {
-	glm::vec3 axis = top - bottom;
-	float length = glm::length(axis);
-	if (length < 0.001f) return;
-
-	glm::vec3 axisNorm = axis / length;
-	glm::vec3 arbitrary = (fabs(axisNorm.y) < 0.9f) ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
-	glm::vec3 perp1 = glm::normalize(glm::cross(axisNorm, arbitrary));
-	glm::vec3 perp2 = glm::cross(axisNorm, perp1);
-
-	unsigned baseIdx = vertices.size();
-	for (int i = 0; i <= SUPPORT_NUM_SIDES; ++i) {
-		float angle = i * 2.0f * std::numbers::pi_v<float> / SUPPORT_NUM_SIDES;
-		glm::vec3 offset = perp1 * cos(angle) * radius + perp2 * sin(angle) * radius;
-		glm::vec3 normal = glm::normalize(offset);
-		vertices.push_back({ bottom + offset, normal });
-		vertices.push_back({ top + offset, normal });
-	}
+TrackPose Tracks::poseAt(float distance) const {
+	return spline.empty() ? index.poseAt(distance) : spline.poseAt(distance);
+}
 
-	for (int i = 0; i < SUPPORT_NUM_SIDES; ++i) {
-		unsigned b0 = baseIdx + i * 2, b1 = b0 + 1, b2 = baseIdx + (i + 1) * 2, b3 = b2 + 1;
-		indices.insert(indices.end(), { b0, b2, b1, b1, b2, b3 });
+void Tracks::poseAt(std::span<const float> distances, std::span<TrackPose> poses) const {
+	if (spline.empty()) {
+		index.poseAt(distances, poses);
+		return;
 	}
-}
+	for (size_t i = 0; i < std::min(distances.size(), poses.size()); ++i)
+		poses[i] = spline.poseAt(distances[i]);
+}
\ No newline at end of file
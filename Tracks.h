@@ -1,35 +1,70 @@
 #pragma once
 #include "DataClasses.h"
+#include "TrackBuilder.h"
+#include "TrackIndex.h"
+#include "TrackSpline.h"
+#include "Frustum.h"
 #include <glm/glm.hpp>
 #include "Shader.h"
+#include <future>
+#include <memory>
 #include <vector>
 #include <string>
+#include <span>
 
 class Tracks {
-	struct ElipseExtremes {
-		size_t leftEndIdx = 0, rightEndIdx = 0;
-		float minY = -1;
+public:
+	struct Stats : TrackBuilder::Stats {
+		size_t splineControlPointCount = 0;
+		size_t reloadUploadBytes = 0;
+	};
+
+	struct DrawStats {
+		size_t chunksSubmitted = 0, chunksCulled = 0;
+		size_t trianglesSubmitted = 0, trianglesCulled = 0;
 	};
 
+private:
+	struct CpuOnly {};
+
 	unsigned int VAO = 0, VBO = 0, EBO = 0;
-	unsigned int tracksIndicesCount = 0;
-	std::vector<unsigned int> indices;
-	std::vector<Vertex> vertices;
-
-	void buildMesh(const std::string& filePath);
-	std::vector<std::pair<float, float>> LoadPoints(const std::string& filePath);
-	ElipseExtremes findEllipseExtremes(const std::vector<std::pair<float, float>>& points2d);
-	void computeCenters(const std::vector<std::pair<float, float>>& points2d, Tracks::ElipseExtremes extremes);
-	void computePerpendiculars();
-	void buildSegmentGeometry();
-	void addQuadFace(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2, glm::vec3 v3, glm::vec3 n);
-	void buildSupport();
-	void addSupportColumn(const glm::vec3& topCenter, const glm::vec3& perp, std::vector<std::pair<glm::vec3, glm::vec3>>& previousBraces, float minY);
-	void addCylinder(const glm::vec3& bottom, const glm::vec3& top, float radius);
+	unsigned int supportVAO = 0, cylinderVBO = 0, cylinderEBO = 0, instanceVBO = 0;
+	unsigned int cylinderIndicesCount = 0;
+	TrackBuilder mesh;
+	std::string filePath;
+	float simplifyTolerance;
+	size_t splineControlPoints;
+	std::future<std::unique_ptr<Tracks>> pendingReload;
+	bool reloadQueued = false;
+	Stats stats;
+	mutable DrawStats drawStats;
+
+	Tracks(CpuOnly, const std::string& filePath, float simplifyTolerance, size_t splineControlPoints);
+
+	void upload();
+	void swapIn(Tracks& next);
+
+	template<typename Draw>
+	void drawChunks(const std::vector<TrackBuilder::Chunk>& chunks, const Frustum& frustum, unsigned int indicesPerItem, Draw&& draw) const;
 
 public:
-	std::vector<TrackPoint> points;
+	std::span<const TrackPoint> points;
+	TrackIndex index;
+	TrackSpline spline;
+
+	static constexpr float DEFAULT_SIMPLIFY_TOLERANCE = 0.005f;
+
+	// splineControlPoints > 0 fits a TrackSpline through the samples and rides it instead of the samples.
+	Tracks(const std::string& filePath, float simplifyTolerance = DEFAULT_SIMPLIFY_TOLERANCE, size_t splineControlPoints = 0);
+	void draw(const Shader& shader, const glm::mat4& viewProjection) const;
+	const Stats& getStats() const;
+	const DrawStats& getDrawStats() const;
+
+	void reload();
+	bool applyReload();
 
-	Tracks(const std::string& filePath);
-	void draw(const Shader& shader) const;
+	float length() const;
+	float pitchAt(float distance) const;
+	TrackPose poseAt(float distance) const;
+	void poseAt(std::span<const float> distances, std::span<TrackPose> poses) const;
 };
\ No newline at end of file
@@ -1,45 +1,33 @@
 #pragma once
+#include "Circuit.h"
 #include "Character.h"
 #include "TrainCar.h"
 #include "Tracks.h"
 #include "Shader.h"
+#include <cstdint>
+#include <random>
 #include <vector>
 
-enum class TrainMode {
-	WAITING,
-	RUNNING,
-	EMERGENCY_STOP,
-	SICK_MODE,
-	FINISHED
-};
-
-class Train {
-	float offset, currentSpeed, preStopSpeed, stopDistance;
-	TrainMode mode = TrainMode::WAITING;
+// The circuit on the loaded Tracks with everything it takes to draw it: the cars, the riders and the camera.
+class Train : public Circuit {
+	std::vector<Model> riderModels;
 	std::vector<Character> characters;
 	const Tracks& tracks;
-	int charactersCount;
-	float sleepTimer;
 	TrainCar car;
 	Model belt;
+	std::vector<float> carDistances;
+	std::vector<TrackPose> carTransforms;
+	size_t poseLookups;
 
-	OrientedPoint getCarTransform(int carIndex) const;
+	void updateCarTransforms();
 
 public:
-	Train(const Tracks& tracks);
+	Train(const Tracks& tracks, float simulationStep, int trainCount = 1, int carCount = TrainPhysics::DEFAULT_CAR_COUNT, std::uint32_t seed = std::random_device()());
 
 	void draw(const Shader& shader, bool cameraInTrain) const;
-	void update(float delta);
+	void interpolate(float alpha);
+	void trackChanged();
+	size_t getPoseLookupCount() const;
 
 	OrientedPoint getCameraTransform() const;
-	void buckleUp(int seatNumber);
-	void shuffleCharacters();
-
-	TrainMode getMode() const;
-	void setMode(TrainMode newMode);
-	void makeSick(int seatNumber);
-	int getCharactersCount() const;
-	void addCharacter();
-	void start();
-	void reset();
 };
\ No newline at end of file
@@ -22,12 +22,15 @@ namespace {
 	constexpr glm::vec3 WHEEL_COLOR(0.1f, 0.1f, 0.1f);
 	constexpr glm::vec3 CAR_COLOR(0.85f, 0.1f, 0.1f);
 	constexpr glm::vec3 SEAT_COLOR(0.5f, 0.5f, 0.5f);
+
+	constexpr VertexFormat TRAIN_CAR_VERTEX_FORMAT = VertexFormat::PACKED;
 }
 
 TrainCar::TrainCar() :
-	bodyIndicesStart(0), bodyIndicesCount(0), stripeIndicesStart(0), stripeIndicesCount(0),
-	seatIndicesStart(0), seatIndicesCount(0), wheelIndicesStart(0), wheelIndicesCount(0) {
+	stripeIndicesStart(0), stripeIndicesCount(0), wheelIndicesStart(0), wheelIndicesCount(0),
+	bodyIndicesStart(0), bodyIndicesCount(0), seatIndicesStart(0), seatIndicesCount(0) {
 	buildMesh();
+	encodedVertices = EncodedVertices(vertices, TRAIN_CAR_VERTEX_FORMAT);
 
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
@@ -35,15 +38,14 @@ TrainCar::TrainCar() :
 	glBindVertexArray(VAO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+	encodedVertices.upload();
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-	glEnableVertexAttribArray(1);
 	glBindVertexArray(0);
+
+	indices = {};
+	vertices = {};
+	encodedVertices.releaseData();
 }
 
 TrainCar::~TrainCar() {
@@ -206,19 +208,13 @@ void TrainCar::addHalfCylinder(const glm::vec3& center, const glm::vec3& axis, f
 	}
 }
 
-void TrainCar::draw(const Shader& shader, const glm::vec3& position, const glm::vec3& perp, float pitch) const {
-	glm::vec3 right = glm::normalize(perp);
-	glm::vec3 forward = -glm::normalize(glm::vec3(-right.z * cos(-pitch), sin(-pitch), right.x * cos(-pitch)));
-	glm::vec3 up = glm::normalize(glm::cross(right, forward));
-
-	glm::mat4 model(1.0f);
-	model[0] = glm::vec4(forward, 0.0f);
-	model[1] = glm::vec4(up, 0.0f);
-	model[2] = glm::vec4(right, 0.0f);
+void TrainCar::draw(const Shader& shader, const glm::vec3& position, const glm::quat& orientation) const {
+	glm::mat4 model = glm::mat4_cast(orientation);
 	model[3] = glm::vec4(position, 1.0f);
 
 	shader.setMat4("model", glm::value_ptr(model));
 	shader.setBool("useTexture", false);
+	encodedVertices.bind(shader);
 	glBindVertexArray(VAO);
 
 	struct { const glm::vec3& color; unsigned start, count; } parts[] = {
@@ -234,4 +230,5 @@ void TrainCar::draw(const Shader& shader, const glm::vec3& position, const glm::
 	}
 
 	glBindVertexArray(0);
+	EncodedVertices::unbind(shader);
 }
\ No newline at end of file
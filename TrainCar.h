@@ -1,5 +1,6 @@
 #pragma once
 #include "DataClasses.h"
+#include "VertexFormat.h"
 #include <glm/glm.hpp>
 #include "Shader.h"
 #include <vector>
@@ -8,6 +9,7 @@ class TrainCar {
 	unsigned int VAO = 0, VBO = 0, EBO = 0;
 	std::vector<unsigned int> indices;
 	std::vector<Vertex> vertices;
+	EncodedVertices encodedVertices;
 
 	unsigned int stripeIndicesStart, stripeIndicesCount;
 	unsigned int wheelIndicesStart, wheelIndicesCount;
@@ -28,5 +30,5 @@ public:
 	TrainCar();
 	~TrainCar();
 
-	void draw(const Shader& shader, const glm::vec3& position, const glm::vec3& perp, float pitch) const;
+	void draw(const Shader& shader, const glm::vec3& position, const glm::quat& orientation) const;
 };
\ No newline at end of file
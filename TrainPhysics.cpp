@@ -0,0 +1,154 @@
+#include "TrainPhysics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	constexpr float TRAIN_START_OFFSET = TrainPhysics::START_OFFSET, TRAIN_CAR_SPACE = TrainPhysics::CAR_SPACE;
+
+	constexpr float TRAIN_MIN_SPEED = 3.8f, TRAIN_MAX_SPEED = 64.0f, TRAIN_MAX_SPEED_SICK = 8.0f;
+	constexpr float SLOWDOWN_DISTANCE = 10.0f, FINISH_SLOWDOWN_DISTANCE_SICK = 18.0f;
+	constexpr float SICK_STOP_TIME = 10.0f;
+	constexpr float FINISH_SLOWDOWN_DISTANCE = TrainPhysics::FINISH_SLOWDOWN_DISTANCE, FINISHED_DISTANCE = 0.05f;
+	constexpr float TRAIN_FLAT_ACCEL = 7.0f, TRAIN_SLOPE_FACTOR = 32.0f;
+	constexpr float MAX_RIDE_DURATION = 600.0f;
+	constexpr float BLOCK_MARGIN = 5.0f;
+}
+
+TrainState TrainPhysics::atStation() {
+	return { TRAIN_START_OFFSET, TRAIN_START_OFFSET, TRAIN_START_OFFSET, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, TrainMode::WAITING };
+}
+
+float TrainPhysics::length(int carCount) {
+	return carCount * TRAIN_CAR_SPACE;
+}
+
+// Equal blocks of at least one train length plus a margin.
+int TrainPhysics::blockCount(float totalLength, int carCount) {
+	return std::max(3, int(totalLength / (length(carCount) + BLOCK_MARGIN)));
+}
+
+// One block always stays empty so the trains can move up. A train too long for three blocks
+// of its own length has the circuit to itself.
+int TrainPhysics::maxRunningTrains(float totalLength, int carCount) {
+	int fitting = int(totalLength / (length(carCount) + BLOCK_MARGIN));
+	return fitting >= 3 ? fitting - 1 : 1;
+}
+
+// Plays the RUNNING model once at the simulation rate, from the launch to the stop at the station.
+// The speed only depends on where the cars are on the track, so the ride itself just replays it.
+SpeedProfile TrainPhysics::buildSpeedProfile(float totalLength, const std::function<float(float)>& pitchAt, float simulationStep, int carCount) {
+	float endDist = totalLength + TRAIN_START_OFFSET;
+	float distance = TRAIN_START_OFFSET, speed = 0.0f, entrySpeed = 0.0f;
+	std::vector<float> distances = { distance }, speeds = { speed };
+
+	while (distances.size() * simulationStep < MAX_RIDE_DURATION) {
+		float remaining = endDist - distance;
+		if (remaining <= FINISHED_DISTANCE) {
+			distances.push_back(endDist);
+			speeds.push_back(0.0f);
+			break;
+		}
+
+		if (remaining <= FINISH_SLOWDOWN_DISTANCE) {
+			float t = std::clamp(remaining / FINISH_SLOWDOWN_DISTANCE, 0.0f, 1.0f);
+			speed = entrySpeed * std::pow(t, 0.82f);
+		} else {
+			entrySpeed = speed;
+			float weightedSum = 0.0f, totalWeight = 0.0f;
+
+			for (int i = 0; i < carCount; i++) {
+				float targetDist = distance - i * TRAIN_CAR_SPACE;
+				while (targetDist < 0.0f) targetDist += totalLength;
+				while (targetDist >= totalLength) targetDist -= totalLength;
+
+				float slope = -std::sin(pitchAt(targetDist));
+				float accel = TRAIN_FLAT_ACCEL + slope * TRAIN_SLOPE_FACTOR;
+				if (speed < TRAIN_MIN_SPEED) accel = TRAIN_SLOPE_FACTOR;
+
+				float weight = float(carCount - i);
+				weightedSum += std::clamp(speed + accel * simulationStep, 0.0f, TRAIN_MAX_SPEED) * weight;
+				totalWeight += weight;
+			}
+
+			speed = weightedSum / totalWeight;
+		}
+
+		distance += speed * simulationStep;
+		distances.push_back(distance);
+		speeds.push_back(speed);
+	}
+
+	return SpeedProfile(simulationStep, std::move(distances), std::move(speeds));
+}
+
+// One step of a train on its own, without blocks. Reaching the station is reported as FINISHED
+// and left to the caller, which knows where the train goes next.
+TrainState TrainPhysics::step(const TrainState& train, const SpeedProfile& speedProfile, float totalLength, float delta) {
+	TrainState next = train;
+	if (train.sleepTimer > 0.0f) {
+		next.sleepTimer -= delta;
+		return next;
+	}
+
+	if (train.mode == TrainMode::RUNNING) {
+		next.rideTime += delta;
+		if (next.rideTime >= speedProfile.duration()) {
+			next.mode = TrainMode::FINISHED;
+			return next;
+		}
+
+		next.offset = speedProfile.distanceAt(next.rideTime);
+		next.currentSpeed = speedProfile.speedAt(next.rideTime);
+	} else if (train.mode == TrainMode::EMERGENCY_STOP) {
+		float remaining = train.stopDistance - train.offset;
+		float t = std::clamp(remaining / SLOWDOWN_DISTANCE, 0.0f, 1.0f);
+		next.currentSpeed = train.preStopSpeed * std::pow(t, 0.82f);
+
+		if (remaining <= FINISHED_DISTANCE) {
+			next.offset = train.stopDistance;
+			next.currentSpeed = 0.0f;
+			next.sleepTimer = SICK_STOP_TIME;
+			next.mode = TrainMode::SICK_MODE;
+			return next;
+		}
+
+		next.offset += next.currentSpeed * delta;
+	} else if (train.mode == TrainMode::SICK_MODE) {
+		float accel = TRAIN_FLAT_ACCEL;
+		next.currentSpeed += accel * delta;
+		next.currentSpeed = std::clamp(next.currentSpeed, 0.0f, TRAIN_MAX_SPEED_SICK);
+
+		float endDist = totalLength + TRAIN_START_OFFSET;
+		float remaining = endDist - train.offset;
+
+		if (remaining <= FINISH_SLOWDOWN_DISTANCE_SICK) {
+			float t = std::clamp(remaining / FINISH_SLOWDOWN_DISTANCE_SICK, 0.0f, 1.0f);
+			next.currentSpeed = train.preStopSpeed * std::pow(t, 0.7f);
+
+			if (remaining <= FINISHED_DISTANCE) {
+				next.mode = TrainMode::FINISHED;
+				return next;
+			}
+		} else {
+			next.preStopSpeed = next.currentSpeed;
+		}
+
+		next.offset += next.currentSpeed * delta;
+	}
+	return next;
+}
+
+void TrainPhysics::emergencyStop(TrainState& train, float totalLength) {
+	// A train already standing, e.g. held at the end of its block, has no speed to brake from and would
+	// never reach the stop point, so it waits out the stop where it is and heads back from there.
+	if (train.currentSpeed <= 0.0f) {
+		train.stopDistance = train.offset;
+		train.preStopSpeed = 0.0f;
+		train.sleepTimer = SICK_STOP_TIME;
+		train.mode = TrainMode::SICK_MODE;
+		return;
+	}
+	train.stopDistance = std::min(train.offset + SLOWDOWN_DISTANCE, totalLength + TRAIN_START_OFFSET);
+	train.mode = TrainMode::EMERGENCY_STOP;
+	train.preStopSpeed = train.currentSpeed;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include "SpeedProfile.h"
+#include <functional>
+
+enum class TrainMode {
+	WAITING,
+	RUNNING,
+	EMERGENCY_STOP,
+	SICK_MODE,
+	FINISHED
+};
+
+// Everything that moves, per train; kept side by side so one pass over the vector steps them all.
+struct TrainState {
+	float offset, previousOffset, renderOffset;
+	float currentSpeed, preStopSpeed, stopDistance;
+	float rideTime, sleepTimer;
+	TrainMode mode;
+};
+
+// How one train moves on its own, without blocks, passengers or anything to draw, so the game,
+// the fleet simulator and the headless ride simulator all follow the same rules.
+class TrainPhysics {
+public:
+	static constexpr float START_OFFSET = -3.8f, CAR_SPACE = 8.6f;
+	static constexpr int DEFAULT_CAR_COUNT = 4, MIN_CAR_COUNT = 2, MAX_CAR_COUNT = 64;
+	static constexpr float FINISH_SLOWDOWN_DISTANCE = 42.0f;
+
+	static TrainState atStation();
+	static float length(int carCount);
+	static int blockCount(float totalLength, int carCount);
+	static int maxRunningTrains(float totalLength, int carCount);
+	static SpeedProfile buildSpeedProfile(float totalLength, const std::function<float(float)>& pitchAt, float simulationStep, int carCount);
+	static TrainState step(const TrainState& train, const SpeedProfile& speedProfile, float totalLength, float delta);
+	static void emergencyStop(TrainState& train, float totalLength);
+};
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace {
+	constexpr float POSITION_STEPS = 65535.0f, NORMAL_STEPS = 511.0f;
+
+	glm::vec2 signNotZero(const glm::vec2& v) {
+		return { v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f };
+	}
+
+	std::uint32_t packNormal(const glm::vec3& normal) {
+		glm::vec2 octahedral = glm::vec2(normal.x, normal.y) / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+		if (normal.z < 0.0f)
+			octahedral = (glm::vec2(1.0f) - glm::abs(glm::vec2(octahedral.y, octahedral.x))) * signNotZero(octahedral);
+
+		auto snorm10 = [](float value) {
+			return std::uint32_t(int(std::round(std::clamp(value, -1.0f, 1.0f) * NORMAL_STEPS))) & 0x3FFu;
+			};
+		return snorm10(octahedral.x) | (snorm10(octahedral.y) << 10);
+	}
+}
+
+EncodedVertices::EncodedVertices(std::span<const Vertex> vertices, VertexFormat format) : format(format) {
+	if (format == VertexFormat::FLOAT) {
+		bytes.resize(vertices.size_bytes());
+		std::memcpy(bytes.data(), vertices.data(), vertices.size_bytes());
+		return;
+	}
+
+	for (const Vertex& vertex : vertices)
+		bounds.grow(vertex.position);
+	glm::vec3 extent = glm::max(bounds.max - bounds.min, glm::vec3(0.0001f));
+
+	bytes.resize(vertices.size() * sizeof(PackedVertex));
+	PackedVertex* packed = reinterpret_cast<PackedVertex*>(bytes.data());
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		glm::vec3 position = glm::clamp((vertices[i].position - bounds.min) / extent, 0.0f, 1.0f) * POSITION_STEPS;
+		for (int axis = 0; axis < 3; ++axis)
+			packed[i].position[axis] = std::uint16_t(std::round(position[axis]));
+		packed[i].padding = 0;
+		packed[i].normal = packNormal(vertices[i].normal);
+	}
+}
+
+EncodedVertices::EncodedVertices(VertexFormat format, const BoundingBox& bounds, std::vector<std::byte> bytes)
+	: format(format), bounds(bounds), bytes(std::move(bytes)) {
+}
+
+VertexFormat EncodedVertices::getFormat() const {
+	return format;
+}
+
+const BoundingBox& EncodedVertices::getBounds() const {
+	return bounds;
+}
+
+const std::vector<std::byte>& EncodedVertices::data() const {
+	return bytes;
+}
+
+void EncodedVertices::releaseData() {
+	bytes = {};
+}
+
+size_t EncodedVertices::stride() const {
+	return format == VertexFormat::PACKED ? sizeof(PackedVertex) : sizeof(Vertex);
+}
\ No newline at end of file
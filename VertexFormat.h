@@ -0,0 +1,45 @@
+#pragma once
+#include "DataClasses.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <span>
+
+class Shader;
+
+enum class VertexFormat {
+	FLOAT,
+	PACKED
+};
+
+// 12 bytes instead of 24: position as 16-bit unorm inside the mesh bounds, normal as an
+// octahedral pair in the x and y lanes of a GL_INT_2_10_10_10_REV word.
+struct PackedVertex {
+	std::uint16_t position[3];
+	std::uint16_t padding;
+	std::uint32_t normal;
+};
+
+class EncodedVertices {
+	VertexFormat format = VertexFormat::FLOAT;
+	BoundingBox bounds;
+	std::vector<std::byte> bytes;
+
+public:
+	EncodedVertices() = default;
+	EncodedVertices(std::span<const Vertex> vertices, VertexFormat format);
+	EncodedVertices(VertexFormat format, const BoundingBox& bounds, std::vector<std::byte> bytes);
+
+	VertexFormat getFormat() const;
+	const BoundingBox& getBounds() const;
+	const std::vector<std::byte>& data() const;
+	size_t stride() const;
+
+	// Defined in VertexFormatGL.cpp so the headless track compiler links without GL.
+	void upload() const;
+	// Drops the encoded bytes once they are in a GPU buffer; the format and bounds stay for bind().
+	void releaseData();
+	void setAttributes() const;
+	void bind(const Shader& shader) const;
+	static void unbind(const Shader& shader);
+};
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "VertexFormat.h"
+#include "Shader.h"
+#include <GL/glew.h>
+#include <cstddef>
+
+void EncodedVertices::upload() const {
+	glBufferData(GL_ARRAY_BUFFER, bytes.size(), bytes.data(), GL_STATIC_DRAW);
+	setAttributes();
+}
+
+void EncodedVertices::setAttributes() const {
+	if (format == VertexFormat::PACKED) {
+		glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+		glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+	} else {
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+	}
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+}
+
+void EncodedVertices::bind(const Shader& shader) const {
+	bool packed = format == VertexFormat::PACKED;
+	glm::vec3 scale = packed ? glm::max(bounds.max - bounds.min, glm::vec3(0.0001f)) : glm::vec3(1.0f);
+	glm::vec3 origin = packed ? bounds.min : glm::vec3(0.0f);
+
+	shader.setBool("quantized", packed);
+	shader.setVec3("positionOrigin", origin.x, origin.y, origin.z);
+	shader.setVec3("positionScale", scale.x, scale.y, scale.z);
+}
+
+void EncodedVertices::unbind(const Shader& shader) {
+	shader.setBool("quantized", false);
+}
\ No newline at end of file
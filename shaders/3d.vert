@@ -2,6 +2,9 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
+layout(location = 3) in vec3 aInstanceBottom;
+layout(location = 4) in vec3 aInstanceTop;
+layout(location = 5) in float aInstanceRadius;
 
 out vec2 TexCoord;
 out vec3 FragPos;
@@ -10,10 +13,38 @@ out vec3 Normal;
 uniform mat4 projection;
 uniform mat4 model;
 uniform mat4 view;
+uniform bool instanced;
+uniform bool quantized;
+uniform vec3 positionOrigin;
+uniform vec3 positionScale;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    vec3 position = aPos;
+    vec3 normal = aNormal;
+
+    if (quantized) {
+        position = positionOrigin + aPos * positionScale;
+        normal = decodeOctahedral(aNormal.xy);
+    }
+
+    if (instanced) {
+        vec3 axis = normalize(aInstanceTop - aInstanceBottom);
+        vec3 arbitrary = abs(axis.y) < 0.9 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+        vec3 perp1 = normalize(cross(axis, arbitrary));
+        vec3 perp2 = cross(axis, perp1);
+        normal = perp1 * aPos.x + perp2 * aPos.y;
+        position = mix(aInstanceBottom, aInstanceTop, aPos.z) + normal * aInstanceRadius;
+    }
+
+    FragPos = vec3(model * vec4(position, 1.0));
+    Normal = mat3(transpose(inverse(model))) * normal;
     TexCoord = aTexCoord;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }